@@ -0,0 +1,953 @@
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_context.h"
+#include "floah-put/input_element.h"
+#include "floah-put/input_element_store.h"
+#include "floah-put/input_replay.h"
+#include "floah-put/input_worker_pool.h"
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////
+    // Scene.
+    ////////////////////////////////////////////////////////////////
+
+    class BenchElement final : public floah::InputElement
+    {
+    public:
+        [[nodiscard]] const InputElement* getInputParent() const noexcept override { return parent; }
+
+        [[nodiscard]] int32_t getInputLayer() const noexcept override { return layer; }
+
+        [[nodiscard]] math::int2 getInputOffset() const noexcept override
+        {
+            return parent ? parent->getInputOffset() + offset : offset;
+        }
+
+        [[nodiscard]] std::optional<floah::InputBounds> getInputBounds() const noexcept override { return bounds; }
+
+        [[nodiscard]] std::optional<floah::InputShape> getInputShape() const noexcept override
+        {
+            return builtinShape ? shape : std::nullopt;
+        }
+
+        [[nodiscard]] bool intersect(const math::int2 point) const noexcept override
+        {
+            return shape ? shape->contains(point) : bounds.contains(point);
+        }
+
+        [[nodiscard]] floah::InputContext::MouseEnterResult
+          onMouseEnter(const floah::InputContext::MouseEnterEvent&) override
+        {
+            events++;
+            return {};
+        }
+
+        [[nodiscard]] floah::InputContext::MouseExitResult
+          onMouseExit(const floah::InputContext::MouseExitEvent&) override
+        {
+            events++;
+            return {};
+        }
+
+        [[nodiscard]] floah::InputContext::MouseClickResult
+          onMouseClick(const floah::InputContext::MouseClickEvent&) override
+        {
+            events++;
+            return {.claim = claim};
+        }
+
+        [[nodiscard]] floah::InputContext::MouseMoveResult
+          onMouseMove(const floah::InputContext::MouseMoveEvent&) override
+        {
+            events++;
+            return {};
+        }
+
+        [[nodiscard]] floah::InputContext::MouseScrollResult
+          onMouseScroll(const floah::InputContext::MouseScrollEvent&) override
+        {
+            events++;
+            return {};
+        }
+
+        [[nodiscard]] bool getInputFocusable() const noexcept override { return focusable; }
+
+        [[nodiscard]] floah::InputContext::Propagation getInputPropagation() const noexcept override
+        {
+            return propagation;
+        }
+
+        [[nodiscard]] floah::InputContext::KeyResult onKey(const floah::InputContext::KeyEvent&) override
+        {
+            events++;
+            return {};
+        }
+
+        [[nodiscard]] floah::InputContext::TextResult onText(const floah::InputContext::TextEvent& text) override
+        {
+            events += text.text.size();
+            return {};
+        }
+
+        [[nodiscard]] floah::InputContext::TimerResult onTimer(const floah::InputContext::TimerEvent& timer) override
+        {
+            events++;
+            static_cast<void>(context->scheduleTimer(*this, timer.deadline + period));
+            return {};
+        }
+
+        const BenchElement* parent = nullptr;
+
+        /**
+         * \brief Context to reschedule timers in.
+         */
+        floah::InputContext* context = nullptr;
+
+        /**
+         * \brief Timer period.
+         */
+        int64_t period = 0;
+
+        int32_t layer = 0;
+
+        math::int2 offset;
+
+        floah::InputBounds bounds;
+
+        /**
+         * \brief Shape tested by intersect. Only passed to the context if builtinShape is set.
+         */
+        std::optional<floah::InputShape> shape;
+
+        bool builtinShape = false;
+
+        bool claim = false;
+
+        bool focusable = false;
+
+        floah::InputContext::Propagation propagation = floah::InputContext::Propagation::None;
+
+        uint64_t events = 0;
+    };
+
+    /**
+     * \brief Non-polymorphic element for InputElementStore.
+     */
+    struct BenchCell
+    {
+        [[nodiscard]] bool intersect(const math::int2 point) const noexcept { return bounds.contains(point); }
+
+        [[nodiscard]] floah::InputBounds getInputBounds() const noexcept { return bounds; }
+
+        [[nodiscard]] floah::InputContext::MouseEnterResult onMouseEnter(const floah::InputContext::MouseEnterEvent&)
+        {
+            events++;
+            return {};
+        }
+
+        [[nodiscard]] floah::InputContext::MouseExitResult onMouseExit(const floah::InputContext::MouseExitEvent&)
+        {
+            events++;
+            return {};
+        }
+
+        floah::InputBounds bounds;
+
+        uint64_t events = 0;
+    };
+
+    /**
+     * \brief Context with a set of elements. Elements are laid out on a grid of cells, each element covering most of
+     * its cell so that there is empty space between elements.
+     */
+    struct Scene
+    {
+        static constexpr int32_t cell = 20;
+
+        static constexpr int32_t size = 16;
+
+        explicit Scene(const floah::InputContext::HitTestMode mode, const bool transformCache)
+        {
+            context.setHitTestMode(mode);
+            context.setTransformCacheEnabled(transformCache);
+            context.setEnter(true);
+        }
+
+        BenchElement& add(const size_t i, const size_t columns)
+        {
+            auto& elem  = *elements.emplace_back(std::make_unique<BenchElement>());
+            const auto x = static_cast<int32_t>(i % columns) * cell;
+            const auto y = static_cast<int32_t>(i / columns) * cell;
+            elem.bounds  = floah::InputBounds{.lower = math::int2(x, y), .upper = math::int2(x + size, y + size)};
+            return elem;
+        }
+
+        void addAll()
+        {
+            for (const auto& elem : elements) static_cast<void>(context.addElement(*elem));
+        }
+
+        /**
+         * \brief Run a single frame with the cursor at the given position.
+         */
+        void frame(const math::int2 cursor)
+        {
+            context.prePoll();
+            context.setCursor(cursor);
+            context.postPoll();
+        }
+
+        floah::InputContext context;
+
+        std::vector<std::unique_ptr<BenchElement>> elements;
+
+        /**
+         * \brief Number of columns of the grid, if created by makeGridScene.
+         */
+        size_t gridColumns = 1;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    // Benchmarks.
+    ////////////////////////////////////////////////////////////////
+
+    /**
+     * \brief Builds a scene and returns a function running a single iteration, which is what is timed.
+     */
+    using Setup = std::function<std::function<void(size_t)>(std::mt19937&)>;
+
+    struct Benchmark
+    {
+        std::string name;
+
+        size_t elements = 0;
+
+        Setup setup;
+    };
+
+    struct Mode
+    {
+        const char* name;
+
+        floah::InputContext::HitTestMode mode;
+    };
+
+    constexpr Mode modes[] = {{"linear", floah::InputContext::HitTestMode::Linear},
+                              {"culling", floah::InputContext::HitTestMode::BoundsCulling},
+                              {"grid", floah::InputContext::HitTestMode::SpatialIndex},
+                              {"hierarchy", floah::InputContext::HitTestMode::Hierarchy}};
+
+    [[nodiscard]] size_t columnsFor(const size_t count)
+    {
+        size_t columns = 1;
+        while (columns * columns < count) columns++;
+        return columns;
+    }
+
+    /**
+     * \brief Create a scene with a number of elements on a square grid. Elements can be adjusted before they are added
+     * to the context.
+     * \param init Called with each element and its index, if set.
+     */
+    [[nodiscard]] std::shared_ptr<Scene> makeGridScene(const Mode                                        mode,
+                                                       const size_t                                      count,
+                                                       const std::function<void(BenchElement&, size_t)>& init = {})
+    {
+        auto scene         = std::make_shared<Scene>(mode.mode, false);
+        scene->gridColumns = columnsFor(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            auto& elem = scene->add(i, scene->gridColumns);
+            if (init) init(elem, i);
+        }
+        scene->addAll();
+        return scene;
+    }
+
+    /**
+     * \brief Flat list of elements on a single layer, except for one element on top. The cursor hovers either the top
+     * element, so that hit-testing can stop at the first element, or empty space, so that all elements are tested.
+     */
+    Setup flat(const Mode mode, const size_t count, const bool hoverTop)
+    {
+        return [=](std::mt19937&) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count, [count](BenchElement& elem, const size_t i) {
+                if (i == count - 1) elem.layer = 1;
+            });
+
+            const auto top    = scene->elements.back()->bounds.lower + math::int2(4, 4);
+            const auto empty  = math::int2(Scene::size + 1, Scene::size + 1);
+            const auto cursor = hoverTop ? top : empty;
+            return [scene, cursor](const size_t it) {
+                scene->frame(cursor + math::int2(static_cast<int32_t>(it & 1), 0));
+            };
+        };
+    }
+
+    /**
+     * \brief Same scene as flat, but no input is submitted. Measures the cost of a frame in which nothing changed.
+     */
+    Setup idle(const Mode mode, const size_t count, const floah::InputContext::UpdateMode updateMode)
+    {
+        return [=](std::mt19937&) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count);
+            scene->context.setUpdateMode(updateMode);
+            scene->frame(math::int2(Scene::size + 1, Scene::size + 1));
+
+            return [scene](size_t) {
+                scene->context.prePoll();
+                scene->context.postPoll();
+            };
+        };
+    }
+
+    /**
+     * \brief Same scene as flat, with the cursor wandering around a small area in steps of a few pixels, as when the
+     * mouse is moved slowly. Without the hover cache, every step queries all elements.
+     */
+    Setup hover(const Mode mode, const size_t count, const bool cache)
+    {
+        return [=](std::mt19937& rng) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count);
+            scene->context.setUpdateMode(floah::InputContext::UpdateMode::Explicit);
+            scene->context.setHoverCacheRadius(cache ? 16 : 0);
+
+            return [scene, &rng](size_t) {
+                const auto step   = [&rng] { return static_cast<int32_t>(rng() % 5) - 2; };
+                const auto cursor = scene->context.getCursor() + math::int2(step(), step());
+                scene->frame(math::int2(std::clamp(cursor.x, 0, 64), std::clamp(cursor.y, 0, 64)));
+            };
+        };
+    }
+
+    /**
+     * \brief Single chain of nested elements. The cursor hovers the deepest element, which is on top.
+     */
+    Setup deep(const Mode mode, const size_t depth, const bool transformCache)
+    {
+        return [=](std::mt19937&) -> std::function<void(size_t)> {
+            auto scene = std::make_shared<Scene>(mode.mode, transformCache);
+            for (size_t i = 0; i < depth; i++)
+            {
+                auto& elem  = scene->add(0, 1);
+                elem.bounds = floah::InputBounds{.lower = math::int2(0, 0), .upper = math::int2(1 << 20, 1 << 20)};
+                elem.offset = math::int2(1, 1);
+                if (i > 0) elem.parent = scene->elements[i - 1].get();
+            }
+            scene->addAll();
+
+            const auto cursor = math::int2(static_cast<int32_t>(depth) + 8, static_cast<int32_t>(depth) + 8);
+            return [scene, cursor](const size_t it) {
+                scene->frame(cursor + math::int2(static_cast<int32_t>(it & 1), 0));
+            };
+        };
+    }
+
+    /**
+     * \brief Same chain as deep, with every 8th element a scroll view that receives the scroll events of its
+     * descendants in the bubble phase. Every iteration scrolls over the deepest element without moving the cursor.
+     */
+    Setup nested(const Mode mode, const size_t depth)
+    {
+        return [=](std::mt19937&) -> std::function<void(size_t)> {
+            auto scene = std::make_shared<Scene>(mode.mode, false);
+            for (size_t i = 0; i < depth; i++)
+            {
+                auto& elem  = scene->add(0, 1);
+                elem.bounds = floah::InputBounds{.lower = math::int2(0, 0), .upper = math::int2(1 << 20, 1 << 20)};
+                elem.offset = math::int2(1, 1);
+                if (i > 0) elem.parent = scene->elements[i - 1].get();
+                if (i % 8 == 0) elem.propagation = floah::InputContext::Propagation::Bubble;
+            }
+            scene->addAll();
+            scene->context.setUpdateMode(floah::InputContext::UpdateMode::Explicit);
+            scene->context.setPropagationEnabled(true);
+            scene->frame(math::int2(static_cast<int32_t>(depth) + 8, static_cast<int32_t>(depth) + 8));
+
+            return [scene](size_t) {
+                scene->context.prePoll();
+                scene->context.setScroll(math::int2(0, 1));
+                scene->context.postPoll();
+            };
+        };
+    }
+
+    /**
+     * \brief Elements that each have their own layer. Every iteration, a number of random elements is moved to a
+     * random layer, forcing the order to be restored.
+     */
+    Setup layers(const Mode mode, const size_t count, const size_t relayer)
+    {
+        return [=](std::mt19937& rng) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(
+              mode, count, [](BenchElement& elem, const size_t i) { elem.layer = static_cast<int32_t>(i); });
+
+            return [scene, count, relayer, &rng](const size_t it) {
+                for (size_t i = 0; i < relayer; i++)
+                    scene->elements[rng() % count]->layer = static_cast<int32_t>(rng() % count);
+                scene->frame(math::int2(static_cast<int32_t>(it % 64), 4));
+            };
+        };
+    }
+
+    /**
+     * \brief The top element claims input on press. The cursor is then dragged across all other elements.
+     */
+    Setup drag(const Mode mode, const size_t count)
+    {
+        return [=](std::mt19937&) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count, [](BenchElement& elem, const size_t i) {
+                if (i != 0) return;
+                elem.layer = 1;
+                elem.claim = true;
+            });
+
+            scene->context.setCursor(math::int2(4, 4));
+            scene->context.setMouseButton(floah::InputContext::MouseButton::Left,
+                                          floah::InputContext::MouseAction::Press,
+                                          floah::InputContext::MouseModifiers{});
+            scene->context.postPoll();
+
+            const auto extent = static_cast<int32_t>(scene->gridColumns) * Scene::cell;
+            return [scene, extent](const size_t it) {
+                const auto step = static_cast<int32_t>(it * 7);
+                scene->frame(math::int2(step % extent, (step / extent * 3) % extent));
+            };
+        };
+    }
+
+    /**
+     * \brief Same as flat, but all elements are stored in a single InputElementStore.
+     */
+    Setup store(const Mode mode, const size_t count, const bool hoverTop)
+    {
+        struct StoreScene
+        {
+            floah::InputContext                 context;
+            floah::InputElementStore<BenchCell> cells;
+        };
+
+        return [=](std::mt19937&) -> std::function<void(size_t)> {
+            auto       scene   = std::make_shared<StoreScene>();
+            const auto columns = columnsFor(count);
+            scene->cells.reserve(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                const auto x = static_cast<int32_t>(i % columns) * Scene::cell;
+                const auto y = static_cast<int32_t>(i / columns) * Scene::cell;
+                scene->cells.emplace().bounds =
+                  floah::InputBounds{.lower = math::int2(x, y), .upper = math::int2(x + Scene::size, y + Scene::size)};
+            }
+            scene->cells.updateBounds();
+            scene->context.setHitTestMode(mode.mode);
+            scene->context.setEnter(true);
+            static_cast<void>(scene->context.addElement(scene->cells));
+
+            const auto top    = scene->cells[count - 1].bounds.lower + math::int2(4, 4);
+            const auto empty  = math::int2(Scene::size + 1, Scene::size + 1);
+            const auto cursor = hoverTop ? top : empty;
+            return [scene, cursor](const size_t it) {
+                scene->context.prePoll();
+                scene->context.setCursor(cursor + math::int2(static_cast<int32_t>(it & 1), 0));
+                scene->context.postPoll();
+            };
+        };
+    }
+
+    /**
+     * \brief Every iteration, a number of random elements is removed and added again before polling.
+     */
+    Setup churn(const Mode mode, const size_t count, const size_t changes)
+    {
+        return [=](std::mt19937& rng) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(
+              mode, count, [](BenchElement& elem, const size_t i) { elem.layer = static_cast<int32_t>(i % 16); });
+
+            return [scene, count, changes, &rng](const size_t it) {
+                for (size_t i = 0; i < changes; i++)
+                {
+                    auto& elem = *scene->elements[rng() % count];
+                    static_cast<void>(scene->context.removeElement(elem));
+                    static_cast<void>(scene->context.addElement(elem));
+                }
+                scene->frame(math::int2(static_cast<int32_t>(it % 64), 4));
+            };
+        };
+    }
+
+    /**
+     * \brief Same scene as flat, in explicit mode. Every iteration, a single random element is raised to the top or
+     * moved by a pixel and invalidated, as when a window is brought to the front or dragged.
+     */
+    Setup invalidate(const Mode mode, const size_t count, const floah::InputContext::Invalidate what)
+    {
+        return [=](std::mt19937& rng) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count);
+            scene->context.setUpdateMode(floah::InputContext::UpdateMode::Explicit);
+            scene->frame(math::int2(Scene::size + 1, Scene::size + 1));
+
+            return [scene, count, what, &rng](const size_t it) {
+                auto& elem = *scene->elements[rng() % count];
+                if (what == floah::InputContext::Invalidate::Layer)
+                    elem.layer = static_cast<int32_t>(it + 1);
+                else
+                    elem.offset = math::int2(static_cast<int32_t>(it & 1), 0);
+                scene->context.invalidate(elem, what);
+                scene->frame(math::int2(Scene::size + 1, Scene::size + 1));
+            };
+        };
+    }
+
+    /**
+     * \brief Flat scene with a number of touch contacts that all move every iteration, so that all pointers are
+     * hit-tested in the same poll.
+     */
+    Setup touch(const Mode mode, const size_t count, const uint32_t contacts)
+    {
+        return [=](std::mt19937& rng) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count);
+            for (uint32_t i = 0; i < contacts; i++) scene->context.setEnter(i + 1, true);
+
+            const auto extent = static_cast<int32_t>(scene->gridColumns) * Scene::cell;
+            return [scene, contacts, extent, &rng](size_t) {
+                scene->context.prePoll();
+                for (uint32_t i = 0; i < contacts; i++)
+                    scene->context.setCursor(
+                      i + 1, math::int2(static_cast<int32_t>(rng() % extent), static_cast<int32_t>(rng() % extent)));
+                scene->context.postPoll();
+            };
+        };
+    }
+
+    /**
+     * \brief Flat scene with a high-resolution mouse on a precision touchpad: every iteration submits a number of
+     * sub-pixel cursor moves, each followed by a fractional scroll, and the coalesce policy decides how many of them
+     * are dispatched.
+     */
+    Setup highRate(
+      const Mode mode, const size_t count, const size_t samples, const bool interleaved, const bool history)
+    {
+        return [=](std::mt19937& rng) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count);
+            scene->context.setCoalescePolicy({.interleaved = interleaved, .history = history});
+
+            const auto extent =
+              static_cast<int32_t>(scene->gridColumns) * Scene::cell * floah::InputContext::subpixelScale;
+            return [scene, samples, extent, &rng](size_t) {
+                scene->context.prePoll();
+                auto cursor = math::int2(static_cast<int32_t>(rng() % extent), static_cast<int32_t>(rng() % extent));
+                for (size_t i = 0; i < samples; i++)
+                {
+                    cursor += math::int2(static_cast<int32_t>(rng() % 64), static_cast<int32_t>(rng() % 64));
+                    scene->context.setPreciseCursor(cursor);
+                    scene->context.setPreciseScroll(math::int2(0, 77));
+                }
+                scene->context.postPoll();
+            };
+        };
+    }
+
+    /**
+     * \brief Same scene as flat, with every element an ellipse and the cursor jumping to a random position every
+     * iteration. The ellipse is either a built-in shape or tested by the element itself.
+     */
+    Setup shapes(const Mode mode, const size_t count, const bool builtin)
+    {
+        return [=](std::mt19937& rng) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count, [builtin](BenchElement& elem, size_t) {
+                elem.shape        = floah::InputShape::ellipse(elem.bounds);
+                elem.builtinShape = builtin;
+            });
+
+            const auto extent = static_cast<int32_t>(scene->gridColumns) * Scene::cell;
+            return [scene, extent, &rng](size_t) {
+                scene->frame(math::int2(static_cast<int32_t>(rng() % extent), static_cast<int32_t>(rng() % extent)));
+            };
+        };
+    }
+
+    /**
+     * \brief Same scene as flat, hit-tested on a worker pool. The cursor hovers empty space, so that all elements are
+     * tested.
+     */
+    Setup parallel(const Mode mode, const size_t count, std::shared_ptr<floah::InputWorkerPool> pool)
+    {
+        return [=](std::mt19937&) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count);
+            scene->context.setWorkerPool(pool.get());
+            scene->context.setParallelThreshold(0);
+
+            const auto cursor = math::int2(Scene::size + 1, Scene::size + 1);
+            return [scene, pool, cursor](const size_t it) {
+                scene->frame(cursor + math::int2(static_cast<int32_t>(it & 1), 0));
+            };
+        };
+    }
+
+    /**
+     * \brief Same scene as flat, with every element running a periodic timer. Periods are random, so that every
+     * iteration a varying number of timers expires. The cursor does not move.
+     */
+    Setup timers(const Mode mode, const size_t count)
+    {
+        return [=](std::mt19937& rng) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count);
+            for (const auto& elem : scene->elements)
+            {
+                elem->context = &scene->context;
+                elem->period  = static_cast<int64_t>(rng() % 1000) + 1;
+                static_cast<void>(scene->context.scheduleTimer(*elem, elem->period));
+            }
+
+            const auto cursor = math::int2(Scene::size + 1, Scene::size + 1);
+            return [scene, cursor](const size_t it) {
+                scene->context.prePoll();
+                scene->context.setTime(static_cast<int64_t>(it) * 16);
+                scene->context.setCursor(cursor);
+                scene->context.postPoll();
+            };
+        };
+    }
+
+    /**
+     * \brief Same scene as flat, with every element focusable and no hit-testing. Every iteration moves focus to the
+     * next element with the tab key and types a burst of text into it.
+     */
+    Setup keyboard(const Mode mode, const size_t count)
+    {
+        return [=](std::mt19937&) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count, [](BenchElement& elem, size_t) { elem.focusable = true; });
+            scene->context.setUpdateMode(floah::InputContext::UpdateMode::Explicit);
+
+            constexpr std::u32string_view text = U"The quick brown fox jumps over the lazy dog.";
+            return [scene, text](size_t) {
+                using KeyAction = floah::InputContext::KeyAction;
+                constexpr auto tab = floah::InputContext::defaultTabKey;
+                scene->context.prePoll();
+                scene->context.setKey(tab, 0, KeyAction::Press, {});
+                scene->context.setKey(tab, 0, KeyAction::Release, {});
+                scene->context.setText(text);
+                scene->context.postPoll();
+            };
+        };
+    }
+
+    /**
+     * \brief Same scene as flat, without any input. Every iteration queries all elements under a batch of random
+     * points at once instead of polling.
+     */
+    Setup query(const Mode mode, const size_t count, const size_t points)
+    {
+        return [=](std::mt19937& rng) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count);
+            scene->frame(math::int2(Scene::size + 1, Scene::size + 1));
+
+            struct Batch
+            {
+                std::vector<math::int2> points;
+
+                std::vector<floah::InputHandle> handles;
+
+                std::vector<uint32_t> offsets;
+            };
+
+            const auto extent = static_cast<int32_t>(scene->gridColumns) * Scene::cell;
+            auto       batch  = std::make_shared<Batch>();
+            batch->points.resize(points);
+            return [scene, batch, extent, &rng](size_t) {
+                for (auto& point : batch->points)
+                    point = math::int2(static_cast<int32_t>(rng() % extent), static_cast<int32_t>(rng() % extent));
+                scene->context.queryElements(batch->points, batch->handles, batch->offsets);
+            };
+        };
+    }
+
+    /**
+     * \brief Same scene as flat, driven by a recording made with InputRecorder. Every iteration replays the entire
+     * recording.
+     */
+    Setup replay(const Mode mode, const size_t count, std::shared_ptr<const floah::InputReplay> recording)
+    {
+        return [=](std::mt19937&) -> std::function<void(size_t)> {
+            auto scene = makeGridScene(mode, count);
+
+            return [scene, recording](size_t) { static_cast<void>(recording->run(scene->context)); };
+        };
+    }
+
+    [[nodiscard]] std::vector<Benchmark> createBenchmarks(const std::shared_ptr<const floah::InputReplay>& recording)
+    {
+        using UpdateMode = floah::InputContext::UpdateMode;
+        using Invalidate = floah::InputContext::Invalidate;
+
+        const auto pool = std::make_shared<floah::InputWorkerPool>(
+          std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1);
+
+        std::vector<Benchmark> benchmarks;
+        const auto             add = [&](std::string name, const size_t elements, Setup setup) {
+            benchmarks.emplace_back(Benchmark{std::move(name), elements, std::move(setup)});
+        };
+
+        for (const auto& mode : modes)
+        {
+            const std::string m = mode.name;
+            for (const size_t count : {100, 1000, 10000, 100000})
+            {
+                const auto n = std::to_string(count);
+                add("flat/top/" + m + "/" + n, count, flat(mode, count, true));
+                add("flat/empty/" + m + "/" + n, count, flat(mode, count, false));
+                add("store/top/" + m + "/" + n, count, store(mode, count, true));
+                add("store/empty/" + m + "/" + n, count, store(mode, count, false));
+                add("idle/poll/" + m + "/" + n, count, idle(mode, count, UpdateMode::Poll));
+                add("idle/explicit/" + m + "/" + n, count, idle(mode, count, UpdateMode::Explicit));
+                add("invalidate/layer/" + m + "/" + n, count, invalidate(mode, count, Invalidate::Layer));
+                add("invalidate/offset/" + m + "/" + n, count, invalidate(mode, count, Invalidate::Offset));
+                add("hover/" + m + "/" + n, count, hover(mode, count, false));
+                add("hover/cached/" + m + "/" + n, count, hover(mode, count, true));
+                add("parallel/" + m + "/" + n, count, parallel(mode, count, pool));
+                add("shapes/builtin/" + m + "/" + n, count, shapes(mode, count, true));
+                add("shapes/custom/" + m + "/" + n, count, shapes(mode, count, false));
+            }
+
+            for (const size_t depth : {16, 256, 2048})
+            {
+                const auto d = std::to_string(depth);
+                add("deep/" + m + "/" + d, depth, deep(mode, depth, false));
+                add("deep/cached/" + m + "/" + d, depth, deep(mode, depth, true));
+                add("nested/" + m + "/" + d, depth, nested(mode, depth));
+            }
+
+            for (const size_t count : {1000, 10000})
+            {
+                const auto n = std::to_string(count);
+                add("layers/" + m + "/" + n, count, layers(mode, count, 16));
+                add("drag/" + m + "/" + n, count, drag(mode, count));
+                add("churn/" + m + "/" + n, count, churn(mode, count, 64));
+                add("touch/" + m + "/" + n, count, touch(mode, count, 10));
+                add("highrate/" + m + "/" + n, count, highRate(mode, count, 16, true, false));
+                add("highrate/history/" + m + "/" + n, count, highRate(mode, count, 16, true, true));
+                add("highrate/split/" + m + "/" + n, count, highRate(mode, count, 16, false, false));
+                add("timers/" + m + "/" + n, count, timers(mode, count));
+                add("keyboard/" + m + "/" + n, count, keyboard(mode, count));
+                add("query/" + m + "/" + n, count, query(mode, count, 1024));
+            }
+
+            if (recording)
+            {
+                for (const size_t count : {1000, 10000})
+                    add("replay/" + m + "/" + std::to_string(count), count, replay(mode, count, recording));
+            }
+        }
+
+        return benchmarks;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Running.
+    ////////////////////////////////////////////////////////////////
+
+    struct Options
+    {
+        size_t iterations = 200;
+
+        size_t warmup = 20;
+
+        uint32_t seed = 1;
+
+        bool json = false;
+
+        bool list = false;
+
+        std::string filter;
+
+        /**
+         * \brief Path of a recording to add replay benchmarks for.
+         */
+        std::string replay;
+    };
+
+    struct Result
+    {
+        std::string name;
+
+        size_t elements = 0;
+
+        double min = 0;
+
+        double median = 0;
+
+        double mean = 0;
+
+        double p95 = 0;
+    };
+
+    [[nodiscard]] Result run(const Benchmark& benchmark, const Options& options)
+    {
+        // Every benchmark gets its own generator so that results do not depend on which other benchmarks ran.
+        std::mt19937 rng(options.seed);
+        const auto   iteration = benchmark.setup(rng);
+
+        for (size_t i = 0; i < options.warmup; i++) iteration(i);
+
+        std::vector<double> samples(options.iterations);
+        for (size_t i = 0; i < options.iterations; i++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            iteration(options.warmup + i);
+            const auto end = std::chrono::steady_clock::now();
+            samples[i]     = std::chrono::duration<double, std::nano>(end - start).count();
+        }
+
+        Result result{.name = benchmark.name, .elements = benchmark.elements};
+        if (samples.empty()) return result;
+
+        std::ranges::sort(samples);
+        double sum = 0;
+        for (const auto s : samples) sum += s;
+        result.min    = samples.front();
+        result.median = samples[samples.size() / 2];
+        result.mean   = sum / static_cast<double>(samples.size());
+        result.p95    = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+        return result;
+    }
+
+    void printCsvHeader() { std::printf("name,elements,iterations,min_ns,median_ns,mean_ns,p95_ns\n"); }
+
+    void printCsv(const Result& r, const Options& options)
+    {
+        std::printf("%s,%zu,%zu,%.0f,%.0f,%.0f,%.0f\n",
+                    r.name.c_str(),
+                    r.elements,
+                    options.iterations,
+                    r.min,
+                    r.median,
+                    r.mean,
+                    r.p95);
+        std::fflush(stdout);
+    }
+
+    void printJson(const std::vector<Result>& results, const Options& options)
+    {
+        std::printf("{\n  \"seed\": %u,\n  \"iterations\": %zu,\n  \"warmup\": %zu,\n  \"results\": [\n",
+                    options.seed,
+                    options.iterations,
+                    options.warmup);
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const auto& r = results[i];
+            std::printf("    {\"name\": \"%s\", \"elements\": %zu, \"min_ns\": %.0f, \"median_ns\": %.0f, "
+                        "\"mean_ns\": %.0f, \"p95_ns\": %.0f}%s\n",
+                        r.name.c_str(),
+                        r.elements,
+                        r.min,
+                        r.median,
+                        r.mean,
+                        r.p95,
+                        i + 1 < results.size() ? "," : "");
+        }
+        std::printf("  ]\n}\n");
+    }
+
+    [[nodiscard]] bool parse(const int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+            const auto        eq  = arg.find('=');
+            const auto        key = arg.substr(0, eq);
+            const auto        val = eq == std::string::npos ? std::string{} : arg.substr(eq + 1);
+
+            if (key == "--json")
+                options.json = true;
+            else if (key == "--csv")
+                options.json = false;
+            else if (key == "--list")
+                options.list = true;
+            else if (key == "--filter")
+                options.filter = val;
+            else if (key == "--iterations")
+                options.iterations = std::stoul(val);
+            else if (key == "--warmup")
+                options.warmup = std::stoul(val);
+            else if (key == "--seed")
+                options.seed = static_cast<uint32_t>(std::stoul(val));
+            else if (key == "--replay")
+                options.replay = val;
+            else
+            {
+                std::fprintf(stderr,
+                             "Usage: %s [--csv|--json] [--list] [--filter=substring] [--iterations=N] [--warmup=N] "
+                             "[--seed=N] [--replay=file]\n",
+                             argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+}  // namespace
+
+int main(const int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        if (!parse(argc, argv, options)) return 1;
+    }
+    catch (const std::exception&)
+    {
+        std::fprintf(stderr, "Invalid argument value.\n");
+        return 1;
+    }
+
+    std::shared_ptr<floah::InputReplay> recording;
+    if (!options.replay.empty())
+    {
+        recording = std::make_shared<floah::InputReplay>();
+        if (!recording->open(options.replay))
+        {
+            std::fprintf(stderr, "Could not open recording %s.\n", options.replay.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<Benchmark> benchmarks = createBenchmarks(recording);
+    std::erase_if(benchmarks, [&](const Benchmark& b) { return b.name.find(options.filter) == std::string::npos; });
+
+    if (options.list)
+    {
+        for (const auto& b : benchmarks) std::printf("%s\n", b.name.c_str());
+        return 0;
+    }
+
+    // CSV rows are printed as soon as they are available, JSON is printed at the end.
+    std::vector<Result> results;
+    if (!options.json) printCsvHeader();
+    for (const auto& b : benchmarks)
+    {
+        results.emplace_back(run(b, options));
+        if (!options.json) printCsv(results.back(), options);
+    }
+    if (options.json) printJson(results, options);
+
+    return 0;
+}
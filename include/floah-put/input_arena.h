@@ -0,0 +1,125 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace floah
+{
+    /**
+     * \brief Memory resource that hands out memory from large blocks and frees all of it at once on reset. Individual
+     * deallocations are ignored.
+     *
+     * Unlike std::pmr::monotonic_buffer_resource, reset keeps the memory. If the last cycle needed more than one block,
+     * they are replaced by a single block of their combined size, so that after a few cycles with a similar amount of
+     * allocations, no more memory is requested from the upstream resource.
+     */
+    class InputArena final : public std::pmr::memory_resource
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty arena. No memory is allocated until the first allocation.
+         * \param resource Resource to allocate blocks from.
+         * \param size Size of the first block in bytes.
+         */
+        explicit InputArena(std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                            size_t                     size     = 4096) noexcept;
+
+        InputArena(const InputArena&) = delete;
+
+        InputArena(InputArena&&) noexcept = delete;
+
+        ~InputArena() noexcept override;
+
+        InputArena& operator=(const InputArena&) = delete;
+
+        InputArena& operator=(InputArena&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] std::pmr::memory_resource* getUpstream() const noexcept;
+
+        /**
+         * \brief Get the total size of all blocks.
+         * \return Size in bytes.
+         */
+        [[nodiscard]] size_t getCapacity() const noexcept;
+
+        /**
+         * \brief Get the number of bytes allocated since the last reset, including padding and the remainder of full
+         * blocks.
+         * \return Size in bytes.
+         */
+        [[nodiscard]] size_t getSize() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Memory.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Free all allocations at once, keeping the memory for the next cycle. Nothing allocated from this
+         * arena may be used afterwards.
+         */
+        void reset() noexcept;
+
+        /**
+         * \brief Free all allocations and return all blocks to the upstream resource.
+         */
+        void release() noexcept;
+
+    private:
+        /**
+         * \brief Header at the start of every block.
+         */
+        struct Block
+        {
+            Block* next = nullptr;
+
+            size_t size = 0;
+        };
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::pmr::memory_resource* upstream = nullptr;
+
+        /**
+         * \brief Size of the next block to allocate.
+         */
+        size_t blockSize = 0;
+
+        /**
+         * \brief All blocks, most recently allocated first. Only the first one is allocated from.
+         */
+        Block* blocks = nullptr;
+
+        size_t blockCount = 0;
+
+        size_t capacity = 0;
+
+        /**
+         * \brief Bytes of all blocks that were filled since the last reset.
+         */
+        size_t filled = 0;
+
+        std::byte* cursor = nullptr;
+
+        std::byte* end = nullptr;
+    };
+}  // namespace floah
@@ -0,0 +1,85 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "math/include_all.h"
+
+namespace floah
+{
+    /**
+     * \brief Axis-aligned bounding box of an input element. The lower corner is inclusive, the upper corner exclusive.
+     */
+    struct InputBounds
+    {
+        math::int2 lower;
+
+        math::int2 upper;
+
+        /**
+         * \brief Returns whether bounds are empty, i.e. do not contain any point.
+         * \return True if empty.
+         */
+        [[nodiscard]] bool empty() const noexcept { return lower.x >= upper.x || lower.y >= upper.y; }
+
+        /**
+         * \brief Returns whether point is inside of bounds.
+         * \param point Point.
+         * \return True if point is inside.
+         */
+        [[nodiscard]] bool contains(const math::int2 point) const noexcept
+        {
+            return point.x >= lower.x && point.y >= lower.y && point.x < upper.x && point.y < upper.y;
+        }
+
+        /**
+         * \brief Returns whether bounds share at least one point with other bounds.
+         * \param other Other bounds.
+         * \return True if bounds overlap.
+         */
+        [[nodiscard]] bool overlaps(const InputBounds& other) const noexcept
+        {
+            return lower.x < other.upper.x && lower.y < other.upper.y && other.lower.x < upper.x &&
+                   other.lower.y < upper.y;
+        }
+
+        /**
+         * \brief Get the part of the bounds that is also inside of other bounds.
+         * \param other Other bounds.
+         * \return Clipped bounds. Empty if bounds do not overlap.
+         */
+        [[nodiscard]] InputBounds clip(const InputBounds& other) const noexcept
+        {
+            return InputBounds{.lower = math::int2(std::max(lower.x, other.lower.x), std::max(lower.y, other.lower.y)),
+                               .upper = math::int2(std::min(upper.x, other.upper.x), std::min(upper.y, other.upper.y))};
+        }
+
+        /**
+         * \brief Get the smallest bounds that contain both bounds.
+         * \param other Other bounds.
+         * \return Merged bounds.
+         */
+        [[nodiscard]] InputBounds merge(const InputBounds& other) const noexcept
+        {
+            return InputBounds{.lower = math::int2(std::min(lower.x, other.lower.x), std::min(lower.y, other.lower.y)),
+                               .upper = math::int2(std::max(upper.x, other.upper.x), std::max(upper.y, other.upper.y))};
+        }
+
+        /**
+         * \brief Get bounds translated by an offset.
+         * \param offset Offset.
+         * \return Translated bounds.
+         */
+        [[nodiscard]] InputBounds translate(const math::int2 offset) const noexcept
+        {
+            return InputBounds{.lower = lower + offset, .upper = upper + offset};
+        }
+    };
+}  // namespace floah
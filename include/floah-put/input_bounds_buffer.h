@@ -0,0 +1,135 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_bounds.h"
+
+namespace floah
+{
+    class InputElement;
+
+    /**
+     * \brief Structure-of-arrays copy of the global bounds of a list of input elements, for testing a point against a
+     * block of bounds at once.
+     *
+     * Elements are referred to by their index in the list the buffer was built from. Elements without bounds always
+     * pass the test. Arrays are padded to a whole number of blocks with inverted bounds, which contain no point and
+     * overlap no region.
+     */
+    class InputBoundsBuffer
+    {
+    public:
+        /**
+         * \brief Number of bounds tested by a single call to test.
+         */
+        static constexpr size_t blockSize = 8;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty buffer.
+         * \param resource Resource to allocate the bounds from.
+         */
+        explicit InputBoundsBuffer(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        InputBoundsBuffer(const InputBoundsBuffer&) = delete;
+
+        InputBoundsBuffer(InputBoundsBuffer&&) noexcept = delete;
+
+        ~InputBoundsBuffer() noexcept;
+
+        InputBoundsBuffer& operator=(const InputBoundsBuffer&) = delete;
+
+        InputBoundsBuffer& operator=(InputBoundsBuffer&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of blocks.
+         * \return Number of blocks.
+         */
+        [[nodiscard]] size_t getBlockCount() const noexcept;
+
+        /**
+         * \brief Get the global bounds of an element. Elements without bounds have bounds covering all points.
+         * \param index Element index.
+         * \return Bounds.
+         */
+        [[nodiscard]] InputBounds getBounds(size_t index) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Buffer.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Rebuild the buffer.
+         * \param elements Elements.
+         * \param offsets Offsets of elements.
+         */
+        void build(std::span<InputElement* const> elements, std::span<const math::int2> offsets);
+
+        /**
+         * \brief Change the number of elements. Elements past the new count become padding, new elements must be
+         * updated before they are tested.
+         * \param count Number of elements.
+         */
+        void resize(size_t count);
+
+        /**
+         * \brief Update the bounds of a single element.
+         * \param index Index of element in the list the buffer was built from.
+         * \param elem Element.
+         * \param offset Offset of element.
+         */
+        void update(size_t index, const InputElement& elem, math::int2 offset) noexcept;
+
+        /**
+         * \brief Clear the buffer.
+         */
+        void clear() noexcept;
+
+        /**
+         * \brief Test a point against all bounds in a block.
+         * \param block Block index.
+         * \param point Point in global space.
+         * \return Bit mask with bit i set if element block * blockSize + i contains the point.
+         */
+        [[nodiscard]] uint32_t test(size_t block, math::int2 point) const noexcept;
+
+        /**
+         * \brief Test a region against all bounds in a block.
+         * \param block Block index.
+         * \param region Region in global space.
+         * \return Bit mask with bit i set if the bounds of element block * blockSize + i overlap the region.
+         */
+        [[nodiscard]] uint32_t test(size_t block, const InputBounds& region) const noexcept;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::pmr::vector<int32_t> lowerX;
+
+        std::pmr::vector<int32_t> lowerY;
+
+        std::pmr::vector<int32_t> upperX;
+
+        std::pmr::vector<int32_t> upperY;
+    };
+}  // namespace floah
@@ -4,7 +4,14 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <optional>
+#include <span>
+#include <string_view>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////
@@ -13,13 +20,56 @@
 
 #include "math/include_all.h"
 
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_arena.h"
+#include "floah-put/input_bounds.h"
+#include "floah-put/input_bounds_buffer.h"
+#include "floah-put/input_element_registry.h"
+#include "floah-put/input_focus_chain.h"
+#include "floah-put/input_handle.h"
+#include "floah-put/input_hierarchy.h"
+#include "floah-put/input_layer_order.h"
+#include "floah-put/input_propagation_paths.h"
+#include "floah-put/input_ring_buffer.h"
+#include "floah-put/input_shape_buffer.h"
+#include "floah-put/input_signal.h"
+#include "floah-put/input_spatial_index.h"
+#include "floah-put/input_stats.h"
+#include "floah-put/input_timer_wheel.h"
+#include "floah-put/input_trace.h"
+#include "floah-put/input_transform_cache.h"
+#include "floah-put/input_tree.h"
+
 namespace floah
 {
     class InputElement;
+    class InputProducer;
+    class InputRecorder;
+    class InputWorkerPool;
 
     class InputContext
     {
     public:
+        /**
+         * \brief ID of the pointer driven by the setters without a pointer parameter, i.e. the mouse. Other pointers
+         * (e.g. touch contacts or a pen) can use any other ID.
+         */
+        static constexpr uint32_t mousePointer = 0;
+
+        /**
+         * \brief Default key that moves keyboard focus to the next focusable element (GLFW_KEY_TAB). See setTabKey.
+         */
+        static constexpr int32_t defaultTabKey = 258;
+
+        /**
+         * \brief Number of precise units per pixel of a cursor position and per step of a scroll distance. Precise
+         * values are fixed-point, so that fractional deltas of high-resolution devices add up without drift.
+         */
+        static constexpr int32_t subpixelScale = 256;
+
         enum class MouseButton
         {
             Left   = 0,
@@ -46,11 +96,52 @@ namespace floah
             NumLock  = 32
         };
 
+        /**
+         * \brief Phase of a propagated event (see InputElement::getInputPropagation).
+         */
+        enum class Phase
+        {
+            /**
+             * \brief Event is dispatched to an ancestor of the target, before the target, from the root down.
+             */
+            Capture = 0,
+
+            /**
+             * \brief Event is dispatched to the target itself.
+             */
+            Target = 1,
+
+            /**
+             * \brief Event is dispatched to an ancestor of the target, after the target, from the parent up.
+             */
+            Bubble = 2
+        };
+
+        /**
+         * \brief Phases in which an element receives the click and scroll events of its descendants.
+         */
+        enum class Propagation
+        {
+            None    = 0,
+            Capture = 1,
+            Bubble  = 2,
+            Both    = 3
+        };
+
         /**
          * \brief Properties describing the mouse entering an input element.
          */
         struct MouseEnterEvent
         {
+            /**
+             * \brief Pointer that entered the element.
+             */
+            uint32_t pointer = mousePointer;
+
+            /**
+             * \brief Position of the pointer, in the local space of the element.
+             */
+            math::int2 position{};
         };
 
         struct MouseEnterResult
@@ -62,6 +153,10 @@ namespace floah
          */
         struct MouseExitEvent
         {
+            /**
+             * \brief Pointer that exited the element.
+             */
+            uint32_t pointer = mousePointer;
         };
 
         struct MouseExitResult
@@ -76,14 +171,55 @@ namespace floah
             MouseButton    button;
             MouseAction    action;
             MouseModifiers modifiers;
+
+            /**
+             * \brief Pointer whose button was pressed or released. For touch contacts, use Left.
+             */
+            uint32_t pointer = mousePointer;
+
+            Phase phase = Phase::Target;
+
+            /**
+             * \brief Element the click is for. Differs from the receiving element in the capture and bubble phases.
+             */
+            const InputElement* target = nullptr;
         };
 
         struct MouseClickResult
         {
             /**
              * \brief If true, the current input element will receive all further input until a result with claim set to false is returned.
+             * If several elements claim the same click, the first one in dispatch order does. While an element has
+             * claimed input, only its own result releases the claim.
              */
             bool claim = false;
+
+            /**
+             * \brief If true, the click is not dispatched to any further elements.
+             */
+            bool stopPropagation = false;
+        };
+
+        /**
+         * \brief Raw cursor or scroll event that was merged into a dispatched event. See CoalescePolicy::history.
+         */
+        struct InputSample
+        {
+            /**
+             * \brief Context time at which the event was submitted.
+             */
+            int64_t time = 0;
+
+            /**
+             * \brief Source timestamp of the event, or 0 if unknown.
+             */
+            int64_t timestamp = 0;
+
+            /**
+             * \brief Precise cursor position, in the same space as MouseMoveEvent::preciseCurrent, or precise scroll
+             * distance (see subpixelScale).
+             */
+            math::int2 value{};
         };
 
         /**
@@ -100,6 +236,25 @@ namespace floah
              * \brief Current cursor position.
              */
             math::int2 current;
+
+            /**
+             * \brief Previous and current cursor position in precise units (see subpixelScale). The element receives a
+             * move when only these changed.
+             */
+            math::int2 precisePrevious;
+
+            math::int2 preciseCurrent;
+
+            /**
+             * \brief Pointer that moved.
+             */
+            uint32_t pointer = mousePointer;
+
+            /**
+             * \brief Cursor events merged into this move, oldest first, in the local space of the element like
+             * preciseCurrent. Empty unless CoalescePolicy::history is enabled. Only valid during the call.
+             */
+            std::span<const InputSample> samples;
         };
 
         struct MouseMoveResult
@@ -112,127 +267,1999 @@ namespace floah
         struct MouseScrollEvent
         {
             /**
-             * \brief Horizontal and vertical scroll distance.
+             * \brief Horizontal and vertical scroll distance in whole steps. Fractions of precise scroll distances are
+             * carried over to the next scroll of the pointer over the same element, so that the steps add up.
              */
             math::int2 scroll;
+
+            /**
+             * \brief Scroll distance in precise units (see subpixelScale).
+             */
+            math::int2 preciseScroll;
+
+            /**
+             * \brief Pointer over which was scrolled.
+             */
+            uint32_t pointer = mousePointer;
+
+            /**
+             * \brief Scroll events merged into this one, oldest first. Their values are distances, which do not depend
+             * on the space of the element. Empty unless CoalescePolicy::history is enabled. Only valid during the call.
+             */
+            std::span<const InputSample> samples;
+
+            Phase phase = Phase::Target;
+
+            /**
+             * \brief Element the scroll is for. Differs from the receiving element in the capture and bubble phases.
+             */
+            const InputElement* target = nullptr;
         };
 
         struct MouseScrollResult
         {
+            /**
+             * \brief If true, the scroll is not dispatched to any further elements, e.g. because a nested scroll view
+             * consumed it.
+             */
+            bool stopPropagation = false;
         };
 
-        ////////////////////////////////////////////////////////////////
-        // Constructors.
-        ////////////////////////////////////////////////////////////////
+        /**
+         * \brief Properties describing the mouse resting over an input element for the hover delay (see
+         * setHoverDelay).
+         */
+        struct MouseHoverEvent
+        {
+            /**
+             * \brief Pointer that rested over the element.
+             */
+            uint32_t pointer = mousePointer;
 
-        InputContext();
+            /**
+             * \brief Position of the pointer, in the local space of the element.
+             */
+            math::int2 position{};
+        };
 
-        InputContext(const InputContext&) = delete;
+        struct MouseHoverResult
+        {
+        };
 
-        InputContext(InputContext&&) noexcept = delete;
+        /**
+         * \brief Properties describing a button that was held down on an input element for the long press delay (see
+         * setLongPressDelay).
+         */
+        struct LongPressEvent
+        {
+            MouseButton    button;
+            MouseModifiers modifiers;
 
-        ~InputContext() noexcept;
+            /**
+             * \brief Pointer whose button was held down.
+             */
+            uint32_t pointer = mousePointer;
 
-        InputContext& operator=(const InputContext&) = delete;
+            /**
+             * \brief Position of the pointer, in the local space of the element.
+             */
+            math::int2 position{};
+        };
 
-        InputContext& operator=(InputContext&&) noexcept = delete;
+        struct LongPressResult
+        {
+        };
 
-        ////////////////////////////////////////////////////////////////
-        // Getters.
-        ////////////////////////////////////////////////////////////////
+        /**
+         * \brief Properties describing a button that was pressed twice on an input element within the double click
+         * interval (see setDoubleClickInterval). Dispatched after the click event of the second press.
+         */
+        struct DoubleClickEvent
+        {
+            MouseButton    button;
+            MouseModifiers modifiers;
 
-        [[nodiscard]] int64_t getTime() const noexcept;
+            /**
+             * \brief Pointer whose button was pressed.
+             */
+            uint32_t pointer = mousePointer;
+        };
 
-        [[nodiscard]] bool getFocus() const noexcept;
+        struct DoubleClickResult
+        {
+        };
 
-        [[nodiscard]] math::int2 getCursor() const noexcept;
+        /**
+         * \brief Properties describing a timer scheduled by scheduleTimer that expired.
+         */
+        struct TimerEvent
+        {
+            InputTimerHandle timer;
 
-        ////////////////////////////////////////////////////////////////
-        // Setters.
-        ////////////////////////////////////////////////////////////////
+            int64_t deadline = 0;
 
-        void setTime(int64_t t) noexcept;
+            /**
+             * \brief Value passed to scheduleTimer.
+             */
+            uint64_t data = 0;
+        };
 
-        void setFocus(bool f) noexcept;
+        struct TimerResult
+        {
+        };
 
-        void setEnter(bool e) noexcept;
+        enum class KeyAction
+        {
+            Press   = 0,
+            Release = 1,
+            Repeat  = 2
+        };
 
-        void setCursor(math::int2 c) noexcept;
+        /**
+         * \brief Properties describing a key event on the input element with keyboard focus.
+         */
+        struct KeyEvent
+        {
+            /**
+             * \brief Key code. Its meaning is up to the windowing library (e.g. GLFW key codes).
+             */
+            int32_t key = 0;
 
-        void setMouseButton(MouseButton button, MouseAction action, MouseModifiers mods) noexcept;
+            /**
+             * \brief Platform-specific scancode.
+             */
+            int32_t scancode = 0;
 
-        void clearMouseButton() noexcept;
+            KeyAction action = KeyAction::Press;
 
-        void setScroll(math::int2 s) noexcept;
+            MouseModifiers modifiers{};
+        };
 
-        ////////////////////////////////////////////////////////////////
-        // Elements.
-        ////////////////////////////////////////////////////////////////
+        struct KeyResult
+        {
+            /**
+             * \brief If false, the context handles the key itself (i.e. the tab key moves focus to the next element).
+             */
+            bool handled = false;
+        };
 
         /**
-         * \brief Add an input element to this context.
-         * \param elem Element to add.
+         * \brief Properties describing text input on the input element with keyboard focus.
          */
-        void addElement(InputElement& elem);
+        struct TextEvent
+        {
+            /**
+             * \brief Codepoints of all consecutive text input since the previous key event. Only valid during the call.
+             */
+            std::span<const char32_t> text;
+        };
+
+        struct TextResult
+        {
+        };
 
         /**
-         * \brief Remove an input element from this context.
-         * \param elem Element to remove.
-         * \return True if element was removed, false if it was not in the context.
+         * \brief Properties describing an input element receiving keyboard focus.
          */
-        bool removeElement(InputElement& elem);
+        struct FocusEnterEvent
+        {
+        };
 
-        ////////////////////////////////////////////////////////////////
-        // Frame.
-        ////////////////////////////////////////////////////////////////
+        struct FocusEnterResult
+        {
+        };
 
         /**
-         * \brief Clears data from previous frame. Should be called before polling for events using your input/windowing library.
+         * \brief Properties describing an input element losing keyboard focus.
          */
-        void prePoll();
+        struct FocusExitEvent
+        {
+        };
+
+        struct FocusExitResult
+        {
+        };
 
         /**
-         * \brief Processes all input events. Should be called after polling for events (and passing on the events to this context) using your input/windowing library.
+         * \brief Raw input event, as passed to the context by the setters and queued until the next poll.
          */
-        void postPoll();
+        struct InputEvent
+        {
+            enum class Type
+            {
+                Cursor = 0,
+                Button = 1,
+                Scroll = 2,
+                Enter  = 3,
+                Key    = 4,
+                Text   = 5
+            };
 
-    private:
-        void mouseEnterEvents();
+            Type type = Type::Cursor;
 
-        void mouseMoveEvents();
+            /**
+             * \brief Context time at which the event was submitted.
+             */
+            int64_t time = 0;
 
-        void mouseClickEvents();
+            /**
+             * \brief Source timestamp of the event in nanoseconds of std::chrono::steady_clock, or 0 if unknown. See
+             * setTimestamp.
+             */
+            int64_t timestamp = 0;
 
-        void mouseScrollEvents();
+            /**
+             * \brief Cursor position (Cursor) or scroll distance (Scroll) in precise units (see subpixelScale).
+             */
+            math::int2 value{};
 
-        ////////////////////////////////////////////////////////////////
-        // Member variables.
-        ////////////////////////////////////////////////////////////////
+            /**
+             * \brief Button properties (Button).
+             */
+            MouseClickEvent click{};
 
-        int64_t time = 0;
+            /**
+             * \brief Whether the mouse entered or exited the window (Enter).
+             */
+            bool enter = false;
 
-        bool focus = false;
+            /**
+             * \brief Key properties (Key).
+             */
+            KeyEvent key{};
 
-        bool enter = false;
+            /**
+             * \brief Codepoint (Text).
+             */
+            char32_t codepoint = 0;
+
+            /**
+             * \brief Range of the text buffer of the context holding the codepoints of this and all directly following
+             * text events, which are merged into this one (Text). Only set on queued events.
+             */
+            uint32_t textOffset = 0;
+
+            uint32_t textCount = 0;
 
-        math::int2 previousCursor;
+            /**
+             * \brief Range of the sample buffer of the context holding the samples of this and all events merged into
+             * it (Cursor and Scroll), interleaved with those of other pointers and types. Only set on queued events if
+             * CoalescePolicy::history is enabled.
+             */
+            uint32_t sampleBegin = 0;
 
-        math::int2 cursor;
+            uint32_t sampleEnd = 0;
 
-        std::vector<InputElement*> inputElements;
+            /**
+             * \brief Pointer the event belongs to.
+             */
+            uint32_t pointer = mousePointer;
+        };
 
         /**
-         * \brief Input element that currently contains the cursor.
+         * \brief Strategy used to find the element under the cursor.
          */
-        InputElement* enteredElement = nullptr;
+        enum class HitTestMode
+        {
+            /**
+             * \brief Test all elements in layer order.
+             */
+            Linear = 0,
+
+            /**
+             * \brief Test the cursor against the bounds (see InputElement::getInputBounds) or shapes (see
+             * InputElement::getInputShape) of a block of elements at once, and only test elements that might contain
+             * the cursor.
+             */
+            BoundsCulling = 1,
+
+            /**
+             * \brief Look up elements whose bounds contain the cursor in a uniform grid.
+             */
+            SpatialIndex = 2,
+
+            /**
+             * \brief Walk the element tree (see InputElement::getInputParent) top-down, skipping the descendants of
+             * elements that clip their children (see InputElement::getInputClipChildren) when the cursor is outside of
+             * their bounds.
+             */
+            Hierarchy = 3
+        };
 
         /**
-         * \brief Input element that has claimed input.
+         * \brief Properties of an element that changed. See InputContext::invalidate.
          */
-        InputElement* claimedElement = nullptr;
+        enum class Invalidate : uint32_t
+        {
+            None = 0,
 
-        std::optional<MouseClickEvent> mouseClick;
+            /**
+             * \brief InputElement::getInputLayer changed.
+             */
+            Layer = 1,
 
-        std::optional<MouseScrollEvent> mouseScroll;
-    };
+            /**
+             * \brief InputElement::getInputParent changed.
+             */
+            Hierarchy = 2,
+
+            /**
+             * \brief InputElement::getInputBounds, InputElement::getInputShape or InputElement::getInputClipChildren
+             * changed.
+             */
+            Bounds = 4,
+
+            /**
+             * \brief InputElement::getInputOffset changed. Implies the offsets of all descendants changed as well.
+             */
+            Offset = 8,
+
+            /**
+             * \brief InputElement::getInputFocusable or InputElement::getInputTabIndex changed.
+             */
+            Focus = 16,
+
+            /**
+             * \brief InputElement::getInputPropagation changed.
+             */
+            Propagation = 32,
+
+            All = Layer | Hierarchy | Bounds | Offset | Focus | Propagation
+        };
+
+        /**
+         * \brief Controls how the context detects changes to elements.
+         */
+        enum class UpdateMode
+        {
+            /**
+             * \brief Layers and parents of all elements are queried every poll, and the element under the cursor is
+             * resolved every poll, even if the cursor did not move. Bounds and offsets must still be invalidated when
+             * cached.
+             */
+            Poll = 0,
+
+            /**
+             * \brief Only elements passed to invalidate (and elements that were added or removed) are queried. If
+             * nothing changed and no events were submitted, polling does (almost) nothing.
+             */
+            Explicit = 1
+        };
+
+        /**
+         * \brief Controls which queued events are merged into one.
+         */
+        struct CoalescePolicy
+        {
+            /**
+             * \brief Replace a queued cursor event by a new one instead of dispatching both.
+             */
+            bool cursor = true;
+
+            /**
+             * \brief Add a new scroll event to a queued one instead of dispatching both.
+             */
+            bool scroll = true;
+
+            /**
+             * \brief Also merge with a queued event of the same pointer and type that is only followed by cursor and
+             * scroll events, instead of only with the last queued event. Keeps a pointer that moves while scrolling, or
+             * many pointers moving at once, at a single move and scroll per pointer per poll.
+             */
+            bool interleaved = true;
+
+            /**
+             * \brief Keep the raw events that were merged, see MouseMoveEvent::samples and MouseScrollEvent::samples.
+             */
+            bool history = false;
+        };
+
+        /**
+         * \brief Summary of what changed since the previous call to postPoll, so that a renderer can skip frames in
+         * which input changed nothing. Includes changes made between polls, e.g. by focusElement.
+         */
+        struct FrameSummary
+        {
+            /**
+             * \brief Number of events dispatched to elements, including enter, exit and timer events.
+             */
+            size_t dispatchedEvents = 0;
+
+            /**
+             * \brief Elements that were entered, exited, claimed, released, or gained or lost focus, each listed once.
+             * Removed elements are not included. Valid until the next call to postPoll.
+             */
+            std::span<const InputHandle> changedElements;
+
+            /**
+             * \brief Union of the global bounds (see InputElement::getInputBounds) of the changed elements at the time
+             * they changed, or std::nullopt if no changed element has bounds.
+             */
+            std::optional<InputBounds> damage;
+
+            /**
+             * \brief If true, a changed element has no bounds, so damage does not cover all changes.
+             */
+            bool unboundedDamage = false;
+
+            /**
+             * \brief Earliest context time at which a timer can expire, or the maximum value if no timers are
+             * scheduled. Without new input, there is nothing to do before this time.
+             */
+            int64_t nextTimer = std::numeric_limits<int64_t>::max();
+
+            /**
+             * \brief Number of allocations the context made from its memory resource during this postPoll and the
+             * prePoll before it, including those caused by event handlers that e.g. add elements. 0 once the scene and
+             * the amount of input are stable.
+             */
+            size_t allocations = 0;
+
+            [[nodiscard]] bool dispatched() const noexcept { return dispatchedEvents != 0; }
+
+            [[nodiscard]] bool changed() const noexcept { return !changedElements.empty(); }
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InputContext();
+
+        /**
+         * \brief Construct a context that allocates all of its memory from a resource. Element bookkeeping is pooled
+         * and per-frame scratch space comes from an arena that is reset in prePoll, so that the resource is only used
+         * when the scene or the amount of input grows.
+         * \param resource Memory resource. Must outlive the context. Must be thread-safe if a worker pool is used for
+         * batched queries (see queryElements).
+         */
+        explicit InputContext(std::pmr::memory_resource* resource);
+
+        InputContext(const InputContext&) = delete;
+
+        InputContext(InputContext&&) noexcept = delete;
+
+        ~InputContext() noexcept;
+
+        InputContext& operator=(const InputContext&) = delete;
+
+        InputContext& operator=(InputContext&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] int64_t getTime() const noexcept;
+
+        [[nodiscard]] bool getFocus() const noexcept;
+
+        [[nodiscard]] math::int2 getCursor() const noexcept;
+
+        /**
+         * \brief Get the position of a pointer, including cursor events that are still queued. A pointer that was never
+         * polled does not exist yet.
+         * \param pointer Pointer ID.
+         * \return Position, or (0, 0) if the pointer does not exist.
+         */
+        [[nodiscard]] math::int2 getCursor(uint32_t pointer) const noexcept;
+
+        /**
+         * \brief Get the position of a pointer in precise units (see subpixelScale), including cursor events that are
+         * still queued.
+         * \param pointer Pointer ID.
+         * \return Position, or (0, 0) if the pointer does not exist.
+         */
+        [[nodiscard]] math::int2 getPreciseCursor(uint32_t pointer = mousePointer) const noexcept;
+
+        /**
+         * \brief Get the element a pointer is currently over.
+         * \param pointer Pointer ID.
+         * \return Element or nullptr.
+         */
+        [[nodiscard]] InputElement* getEnteredElement(uint32_t pointer = mousePointer) const noexcept;
+
+        /**
+         * \brief Get the element that has claimed the input of a pointer.
+         * \param pointer Pointer ID.
+         * \return Element or nullptr.
+         */
+        [[nodiscard]] InputElement* getClaimedElement(uint32_t pointer = mousePointer) const noexcept;
+
+        [[nodiscard]] size_t getEventCapacity() const noexcept;
+
+        [[nodiscard]] CoalescePolicy getCoalescePolicy() const noexcept;
+
+        /**
+         * \brief Get the number of events that were dropped because the event queue or a producer queue was full.
+         * \return Number of dropped events since construction.
+         */
+        [[nodiscard]] size_t getDroppedEventCount() const noexcept;
+
+        [[nodiscard]] HitTestMode getHitTestMode() const noexcept;
+
+        [[nodiscard]] bool getTransformCacheEnabled() const noexcept;
+
+        [[nodiscard]] bool getPropagationEnabled() const noexcept;
+
+        [[nodiscard]] UpdateMode getUpdateMode() const noexcept;
+
+        [[nodiscard]] int32_t getHoverCacheRadius() const noexcept;
+
+        [[nodiscard]] InputWorkerPool* getWorkerPool() const noexcept;
+
+        [[nodiscard]] size_t getParallelThreshold() const noexcept;
+
+        [[nodiscard]] int64_t getHoverDelay() const noexcept;
+
+        [[nodiscard]] int64_t getLongPressDelay() const noexcept;
+
+        [[nodiscard]] int64_t getDoubleClickInterval() const noexcept;
+
+        [[nodiscard]] int64_t getKeyRepeatDelay() const noexcept;
+
+        [[nodiscard]] int64_t getKeyRepeatInterval() const noexcept;
+
+        /**
+         * \brief Get the element that has keyboard focus.
+         * \return Element or nullptr.
+         */
+        [[nodiscard]] InputElement* getFocusedElement() const noexcept;
+
+        [[nodiscard]] int32_t getTabKey() const noexcept;
+
+        /**
+         * \brief Returns whether the library was built with statistics support (the FLOAH_PUT_STATS option). Without
+         * it, no statistics are ever collected and the instrumentation has no cost.
+         * \return True if supported.
+         */
+        [[nodiscard]] static bool getStatsSupported() noexcept;
+
+        [[nodiscard]] bool getStatsEnabled() const noexcept;
+
+        /**
+         * \brief Get the statistics collected since they were enabled or last cleared. A frame is recorded at the end
+         * of each postPoll.
+         * \return Statistics.
+         */
+        [[nodiscard]] const InputStats& getStats() const noexcept;
+
+        /**
+         * \brief Get the summary of the last call to postPoll.
+         * \return Summary.
+         */
+        [[nodiscard]] const FrameSummary& getFrameSummary() const noexcept;
+
+        [[nodiscard]] std::pmr::memory_resource* getMemoryResource() const noexcept;
+
+        [[nodiscard]] bool getAllocationCheck() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the current time. Events submitted after this call are stamped with this time.
+         * \param t Time.
+         */
+        void setTime(int64_t t) noexcept;
+
+        /**
+         * \brief Set the source timestamp of the events submitted after this call, i.e. the time at which the OS
+         * delivered them, to measure their latency up to dispatch (see InputStats::getLatencyHistogram and setTracer).
+         * \param ns Timestamp in nanoseconds of std::chrono::steady_clock. 0 (the default) stamps every event with the
+         * time at which it is submitted, but only while statistics are collected or a tracer is set.
+         */
+        void setTimestamp(int64_t ns) noexcept;
+
+        void setFocus(bool f) noexcept;
+
+        /**
+         * \brief Queue a mouse enter/exit window event.
+         * \param e Whether the mouse entered the window.
+         */
+        void setEnter(bool e) noexcept;
+
+        /**
+         * \brief Queue an enter/exit event for a pointer. A touch contact enters when it touches down and exits when
+         * it is lifted.
+         * \param pointer Pointer ID.
+         * \param e Whether the pointer entered the window.
+         */
+        void setEnter(uint32_t pointer, bool e) noexcept;
+
+        /**
+         * \brief Queue a cursor event.
+         * \param c Cursor position.
+         */
+        void setCursor(math::int2 c) noexcept;
+
+        /**
+         * \brief Queue a cursor event for a pointer.
+         * \param pointer Pointer ID.
+         * \param c Pointer position.
+         */
+        void setCursor(uint32_t pointer, math::int2 c) noexcept;
+
+        /**
+         * \brief Queue a cursor event with sub-pixel precision, e.g. from a high-resolution mouse or a pen.
+         * \param c Cursor position in precise units (see subpixelScale).
+         */
+        void setPreciseCursor(math::int2 c) noexcept;
+
+        void setPreciseCursor(uint32_t pointer, math::int2 c) noexcept;
+
+        /**
+         * \brief Queue a mouse button event.
+         * \param button Button.
+         * \param action Action.
+         * \param mods Modifiers.
+         */
+        void setMouseButton(MouseButton button, MouseAction action, MouseModifiers mods) noexcept;
+
+        /**
+         * \brief Queue a button event for a pointer.
+         * \param pointer Pointer ID.
+         * \param button Button.
+         * \param action Action.
+         * \param mods Modifiers.
+         */
+        void setMouseButton(uint32_t pointer, MouseButton button, MouseAction action, MouseModifiers mods) noexcept;
+
+        /**
+         * \brief Remove all queued mouse button and scroll events.
+         */
+        void clearMouseButton() noexcept;
+
+        /**
+         * \brief Queue a scroll event.
+         * \param s Scroll distance.
+         */
+        void setScroll(math::int2 s) noexcept;
+
+        /**
+         * \brief Queue a scroll event for a pointer.
+         * \param pointer Pointer ID.
+         * \param s Scroll distance.
+         */
+        void setScroll(uint32_t pointer, math::int2 s) noexcept;
+
+        /**
+         * \brief Queue a scroll event with fractional steps, e.g. from a precision touchpad. Fractions are accumulated
+         * until they add up to whole steps (see MouseScrollEvent::scroll).
+         * \param s Scroll distance in precise units (see subpixelScale).
+         */
+        void setPreciseScroll(math::int2 s) noexcept;
+
+        void setPreciseScroll(uint32_t pointer, math::int2 s) noexcept;
+
+        /**
+         * \brief Convert whole pixels or scroll steps to precise units, saturating at the range of int32_t.
+         * \param value Pixels or steps.
+         * \return Precise value.
+         */
+        [[nodiscard]] static math::int2 toPrecise(math::int2 value) noexcept;
+
+        /**
+         * \brief Queue a key event for the element with keyboard focus.
+         * \param key Key code.
+         * \param scancode Scancode.
+         * \param action Action.
+         * \param mods Modifiers.
+         */
+        void setKey(int32_t key, int32_t scancode, KeyAction action, MouseModifiers mods) noexcept;
+
+        /**
+         * \brief Queue text input for the element with keyboard focus. Consecutive text input is dispatched at once.
+         * \param codepoint Unicode codepoint.
+         */
+        void setText(char32_t codepoint) noexcept;
+
+        /**
+         * \brief Queue text input for the element with keyboard focus.
+         * \param codepoints Unicode codepoints.
+         */
+        void setText(std::u32string_view codepoints) noexcept;
+
+        /**
+         * \brief Queue text input for the element with keyboard focus. Invalid sequences are replaced by U+FFFD.
+         * \param utf8 UTF-8 encoded text.
+         */
+        void setText(std::string_view utf8) noexcept;
+
+        /**
+         * \brief Set the maximum number of events queued between polls, in addition to the capacity of all producers.
+         * Clears the queue.
+         * \param capacity Capacity.
+         */
+        void setEventCapacity(size_t capacity);
+
+        void setCoalescePolicy(CoalescePolicy policy) noexcept;
+
+        /**
+         * \brief Queue a raw event, e.g. one that was recorded earlier. Unlike with the setters, the time of the event
+         * is kept instead of the context time. An event without a timestamp is stamped like those of the setters.
+         * \param event Event. The text and sample ranges are ignored.
+         */
+        void submitEvent(const InputEvent& event) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Producers.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create a producer through which events can be submitted from another thread. Events from producers
+         * are queued after events submitted directly to the context, at the start of postPoll. Producers must be
+         * created before any thread starts using them and live as long as the context. The queue of the context grows
+         * by the capacity of the producer, so draining it never drops events.
+         * \param capacity Minimum number of events the producer can hold between polls.
+         * \return Producer.
+         */
+        InputProducer& addProducer(size_t capacity = 1024);
+
+        ////////////////////////////////////////////////////////////////
+        // Timers.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the time a pointer must rest over an element before it receives a hover event. The delay restarts
+         * whenever the pointer moves.
+         * \param delay Delay, in the units of setTime. 0 disables hover events.
+         */
+        void setHoverDelay(int64_t delay) noexcept;
+
+        /**
+         * \brief Set the time a button must be held down on an element before it receives a long press event. The
+         * long press is cancelled when the button is released or the pointer exits the element.
+         * \param delay Delay, in the units of setTime. 0 disables long press events.
+         */
+        void setLongPressDelay(int64_t delay) noexcept;
+
+        /**
+         * \brief Set the maximum time between two presses of the same button on the same element for them to form a
+         * double click.
+         * \param interval Interval, in the units of setTime. 0 disables double click events.
+         */
+        void setDoubleClickInterval(int64_t interval) noexcept;
+
+        /**
+         * \brief Schedule a timer for an element. Once the context time reaches the deadline, the element receives a
+         * timer event during postPoll, in order with queued events with the same or a later time. Timers of removed
+         * elements never fire.
+         * \param elem Element.
+         * \param deadline Deadline, in the units of setTime.
+         * \param data Value passed to the event.
+         * \return Handle, or invalid handle if element is not in this context.
+         */
+        InputTimerHandle scheduleTimer(const InputElement& elem, int64_t deadline, uint64_t data = 0);
+
+        /**
+         * \brief Schedule a timer for an element.
+         * \param handle Handle of element.
+         * \param deadline Deadline, in the units of setTime.
+         * \param data Value passed to the event.
+         * \return Handle, or invalid handle if the element handle is not valid.
+         */
+        InputTimerHandle scheduleTimer(InputHandle handle, int64_t deadline, uint64_t data = 0);
+
+        /**
+         * \brief Cancel a timer scheduled by scheduleTimer.
+         * \param timer Timer.
+         * \return True if the timer was cancelled, false if it already fired or was cancelled.
+         */
+        bool cancelTimer(InputTimerHandle timer) noexcept;
+
+        /**
+         * \brief Let the context generate key repeat events while a key is held down, for windowing libraries that do
+         * not. Repeats are sent to the element with keyboard focus, and stop when the key is released, another key is
+         * pressed or the window loses focus. Repeats missed because the context was not polled in time are skipped.
+         * \param delay Time between the press and the first repeat, in the units of setTime. 0 disables key repeat.
+         * \param interval Time between repeats.
+         */
+        void setKeyRepeat(int64_t delay, int64_t interval) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Focus.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the key that moves keyboard focus to the next focusable element, or to the previous one with
+         * Shift held down, when the focused element does not handle it.
+         * \param key Key code, or a value that is never passed to setKey to disable tab traversal.
+         */
+        void setTabKey(int32_t key) noexcept;
+
+        /**
+         * \brief Give keyboard focus to an element. The element does not have to be focusable.
+         * \param elem Element.
+         * \return True if element has focus, false if it is not in this context.
+         */
+        bool focusElement(const InputElement& elem);
+
+        /**
+         * \brief Give keyboard focus to an element.
+         * \param handle Handle of element.
+         * \return True if element has focus, false if the handle is not valid.
+         */
+        bool focusElement(InputHandle handle);
+
+        /**
+         * \brief Remove keyboard focus from the focused element, if any.
+         */
+        void clearFocusedElement();
+
+        /**
+         * \brief Move keyboard focus to the next focusable element in tab order, wrapping around at the end. If the
+         * focused element is not focusable, focus moves to the first one.
+         * \return True if focus moved.
+         */
+        bool focusNext();
+
+        /**
+         * \brief Move keyboard focus to the previous focusable element in tab order, wrapping around at the start.
+         * \return True if focus moved.
+         */
+        bool focusPrevious();
+
+        ////////////////////////////////////////////////////////////////
+        // Recording.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] InputRecorder* getRecorder() const noexcept;
+
+        /**
+         * \brief Set the recorder that receives all input fed to this context (time, focus, events from the context
+         * and its producers, and poll boundaries). See InputReplay to replay a recording.
+         * \param r Recorder or nullptr to stop recording. Must live until it is replaced.
+         */
+        void setRecorder(InputRecorder* r) noexcept;
+
+        /**
+         * \brief Set the tracer that receives the spans of every frame: the duration of postPoll and, for every event
+         * with a source timestamp, when it was dispatched and when its handlers returned.
+         * \param t Tracer or nullptr to stop tracing. Must live until it is replaced.
+         */
+        void setTracer(InputTracer* t) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Stats.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Enable or disable collecting statistics. Has no effect if statistics are not supported.
+         * \param enabled Enabled.
+         */
+        void setStatsEnabled(bool enabled) noexcept;
+
+        /**
+         * \brief Clear all collected statistics.
+         */
+        void clearStats() noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Memory.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Enable or disable the allocation check. While enabled, any allocation from the memory resource of the
+         * context during prePoll or postPoll fails an assertion, so that a debugger stops at its cause. Allocations are
+         * always counted in FrameSummary::allocations, also in builds without assertions.
+         * \param enabled Enabled.
+         */
+        void setAllocationCheck(bool enabled) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Hit-testing.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the update mode.
+         * \param mode Mode.
+         */
+        void setUpdateMode(UpdateMode mode) noexcept;
+
+        /**
+         * \brief Set the hit-test strategy. All modes except Linear cache element bounds and offsets (and Hierarchy
+         * also the element tree), so invalidate must be called whenever they change. Modes only differ in the
+         * order in which elements that are equal under InputElement::compare are tested.
+         * \param mode Mode.
+         */
+        void setHitTestMode(HitTestMode mode) noexcept;
+
+        /**
+         * \brief Set the preferred cell size of the spatial index.
+         * \param size Cell size.
+         */
+        void setSpatialIndexCellSize(int32_t size) noexcept;
+
+        /**
+         * \brief Enable or disable the transform cache. When enabled, the global transform (see
+         * InputElement::getInputOffset) of each element is cached and only recalculated when the element is added or
+         * its offset or that of one of its ancestors is invalidated.
+         * \param enabled Enabled.
+         */
+        void setTransformCacheEnabled(bool enabled) noexcept;
+
+        /**
+         * \brief Enable or disable event propagation. When enabled, click and scroll events are also dispatched to the
+         * ancestors of the receiving element that listen (see InputElement::getInputPropagation): first in the capture
+         * phase from the root down, then to the element itself, then in the bubble phase from the parent up, until a
+         * handler stops propagation. The listening ancestors of each element are cached and only recalculated when
+         * elements are added or removed, or their parent or propagation is invalidated.
+         * \param enabled Enabled.
+         */
+        void setPropagationEnabled(bool enabled) noexcept;
+
+        /**
+         * \brief Set the radius of the hover cache. In all hit-test modes except Linear, the elements whose bounds
+         * overlap a window of this radius around the cursor are gathered once and reused while the cursor stays inside
+         * of the window, so that small cursor moves only test nearby elements. A radius of 0 disables the window.
+         * \param radius Radius.
+         */
+        void setHoverCacheRadius(int32_t radius) noexcept;
+
+        /**
+         * \brief Set the worker pool used to hit-test large element sets on multiple threads. Elements (or blocks of
+         * elements, or candidates returned by a query) are split into chunks that are tested concurrently, and the
+         * top-most hit is kept, so the result is identical to that of a single thread. While a pool is set,
+         * InputElement::intersect can be called concurrently and for more elements than strictly needed.
+         * \param pool Worker pool or nullptr to hit-test on the polling thread only. Must live until it is replaced.
+         */
+        void setWorkerPool(InputWorkerPool* pool) noexcept;
+
+        /**
+         * \brief Set the minimum number of elements (or candidates) that are hit-tested on the worker pool. Smaller
+         * sets are tested on the polling thread, as waking up workers costs more than testing them. Batched queries
+         * count the number of points times the number of elements.
+         * \param threshold Threshold.
+         */
+        void setParallelThreshold(size_t threshold) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Elements.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Add an input element to this context.
+         * \param elem Element to add.
+         * \return Handle to the element. If the element was already added, its existing handle.
+         */
+        InputHandle addElement(InputElement& elem);
+
+        /**
+         * \brief Add a list of input elements to this context.
+         * \param elems Elements to add.
+         */
+        void addElements(std::span<InputElement* const> elems);
+
+        /**
+         * \brief Reserve storage for a number of elements, so that adding elements up to that number does not grow the
+         * registry and layer order.
+         * \param count Number of elements.
+         */
+        void reserveElements(size_t count);
+
+        /**
+         * \brief Remove an input element from this context.
+         * \param elem Element to remove.
+         * \return True if element was removed, false if it was not in the context.
+         */
+        bool removeElement(InputElement& elem);
+
+        /**
+         * \brief Remove an input element from this context.
+         * \param handle Handle of element to remove.
+         * \return True if element was removed, false if the handle is not valid.
+         */
+        bool removeElement(InputHandle handle);
+
+        /**
+         * \brief Remove a list of input elements from this context.
+         * \param elems Elements to remove.
+         * \return Number of elements that were removed.
+         */
+        size_t removeElements(std::span<InputElement* const> elems);
+
+        /**
+         * \brief Remove an input element and all its descendants (see InputElement::getInputParent) from this context.
+         * Descendants are found through the parents seen by the last update of the element order, so with
+         * UpdateMode::Poll, parents changed since the last poll must be invalidated (see Invalidate::Hierarchy) first.
+         * \param root Root of subtree. Does not have to be in the context itself.
+         * \return Number of elements that were removed.
+         */
+        size_t removeSubtree(const InputElement& root);
+
+        /**
+         * \brief Get the element a handle refers to.
+         * \param handle Handle.
+         * \return Element or nullptr if the handle is not valid.
+         */
+        [[nodiscard]] InputElement* getElement(InputHandle handle) const noexcept;
+
+        /**
+         * \brief Get the handle of an element.
+         * \param elem Element.
+         * \return Handle, or invalid handle if element is not in this context.
+         */
+        [[nodiscard]] InputHandle findElement(const InputElement& elem) const noexcept;
+
+        /**
+         * \brief Notify the context that properties of an element changed. Cached data of only the element (and for
+         * layer, hierarchy and offset changes, its descendants) is updated on the next poll.
+         * \param elem Element. Does not have to be in the context itself, so that changes to an ancestor that does not
+         * receive input can be reported.
+         * \param what Changed properties.
+         */
+        void invalidate(const InputElement& elem, Invalidate what);
+
+        /**
+         * \brief Recache the bounds, offsets and tree of all elements on the next poll.
+         */
+        void invalidateBounds() noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Queries.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get all elements that contain a point, in layer order (top-most first). Elements are hit-tested the
+         * same way as for pointers, using the structures of the current hit-test mode and built-in shapes, but
+         * regardless of which element is entered or has claimed input. Changes to elements made since the last poll
+         * are applied first.
+         * \param point Point in global space.
+         * \param handles List that is cleared and filled with the handles of the elements.
+         * \param limit Maximum number of elements per point. 1 only returns the top-most element.
+         */
+        void queryElements(math::int2                point,
+                           std::vector<InputHandle>& handles,
+                           size_t                    limit = std::numeric_limits<size_t>::max());
+
+        /**
+         * \brief Get all elements whose bounds (see InputElement::getInputBounds) overlap a region, in layer order.
+         * Elements without bounds are always returned, as they can contain any point. In the Hierarchy hit-test mode,
+         * bounds are clipped by clipping ancestors. Changes to elements made since the last poll are applied first.
+         * \param region Region in global space.
+         * \param handles List that is cleared and filled with the handles of the elements.
+         */
+        void queryElements(const InputBounds& region, std::vector<InputHandle>& handles);
+
+        /**
+         * \brief Get all elements that contain each of a batch of points, see queryElements for a single point. Large
+         * batches are split over the worker pool (see setWorkerPool and setParallelThreshold).
+         * \param points Points in global space.
+         * \param handles List that is cleared and filled with the handles of the elements of all points, one point
+         * after the other.
+         * \param pointOffsets List that is cleared and filled with points.size() + 1 offsets into handles. The
+         * elements of point i are handles[pointOffsets[i]] up to handles[pointOffsets[i + 1]].
+         * \param limit Maximum number of elements per point.
+         */
+        void queryElements(std::span<const math::int2> points,
+                           std::vector<InputHandle>&   handles,
+                           std::vector<uint32_t>&      pointOffsets,
+                           size_t                      limit = std::numeric_limits<size_t>::max());
+
+        ////////////////////////////////////////////////////////////////
+        // Frame.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Clears data from previous frame. Should be called before polling for events using your input/windowing library.
+         */
+        void prePoll();
+
+        /**
+         * \brief Processes all input events. Should be called after polling for events (and passing on the events to this context) using your input/windowing library.
+         * Queued events are dispatched in the order they were submitted. The elements under all pointers that moved
+         * are resolved together, in a single pass over the elements, before the first event that depends on them.
+         * Timers (hover, long press and those scheduled by scheduleTimer) that expire before an event fire before it,
+         * and all others that expire up to the current time fire at the end.
+         * \return Summary of what changed. Only valid until the next call to postPoll.
+         */
+        const FrameSummary& postPoll();
+
+        /**
+         * \brief Block until there is something for postPoll to process: queued events (including those of
+         * producers), elements that were added, removed or invalidated, or timers that expired at the current time.
+         * Returns immediately if there already is. Use FrameSummary::nextTimer to limit the timeout.
+         * \param timeout Maximum time to wait.
+         * \return True if there is something to process, false on timeout.
+         */
+        bool waitForInput(std::chrono::nanoseconds timeout);
+
+        /**
+         * \brief Wake up a thread blocked in waitForInput, e.g. because something outside of the context needs a new
+         * frame. Can be called from any thread.
+         */
+        void wake() noexcept;
+
+    private:
+        /**
+         * \brief Input state of a single pointer.
+         */
+        struct Pointer
+        {
+            uint32_t id = mousePointer;
+
+            /**
+             * \brief If true, the pointer is inside of the window (or touching it).
+             */
+            bool enter = false;
+
+            /**
+             * \brief If true, the pointer moved or entered/exited, and the element under it must be resolved before
+             * the next event of the pointer is dispatched.
+             */
+            bool pending = false;
+
+            /**
+             * \brief If true, a cursor event made the pointer pending. A following cursor event resolves the pointer
+             * first, so that every position is hit-tested. Enter events are folded into the pending state instead.
+             */
+            bool moved = false;
+
+            /**
+             * \brief If true, the element under the pointer was resolved during the current poll.
+             */
+            bool resolved = false;
+
+            /**
+             * \brief Time of the last event that made the pointer pending.
+             */
+            int64_t time = 0;
+
+            /**
+             * \brief Source timestamps of the cursor and enter events that made the pointer pending, or 0.
+             */
+            int64_t cursorTimestamp = 0;
+
+            int64_t enterTimestamp = 0;
+
+            math::int2 previousCursor{};
+
+            math::int2 cursor{};
+
+            /**
+             * \brief Precise positions, of which previousCursor and cursor are the whole pixels.
+             */
+            math::int2 previousPreciseCursor{};
+
+            math::int2 preciseCursor{};
+
+            /**
+             * \brief Precise position of the last queued cursor event, returned by getCursor before it is polled.
+             */
+            math::int2 submittedCursor{};
+
+            /**
+             * \brief Range of the sample buffer holding the samples of the last cursor event.
+             */
+            uint32_t sampleBegin = 0;
+
+            uint32_t sampleEnd = 0;
+
+            /**
+             * \brief Fraction of a scroll step not yet dispatched, and the element that received the fraction so far.
+             */
+            math::int2 scrollRemainder{};
+
+            InputHandle scrollHandle{};
+
+            /**
+             * \brief Input element that currently contains the pointer. Cleared when the element is removed.
+             */
+            InputElement* enteredElement = nullptr;
+
+            InputHandle enteredHandle{};
+
+            /**
+             * \brief Input element that has claimed the input of the pointer. Cleared when the element is removed.
+             */
+            InputElement* claimedElement = nullptr;
+
+            InputHandle claimedHandle{};
+
+            /**
+             * \brief If true, the last hover resolution can be reused as long as the cursor, entered element and
+             * claimed element are the same. Only set in the Explicit update mode, and cleared whenever the scene
+             * changes.
+             */
+            bool hoverResolved = false;
+
+            math::int2 hoverCursor{};
+
+            InputHandle hoverEntered{};
+
+            InputHandle hoverClaimed{};
+
+            /**
+             * \brief Region around the cursor for which hoverCandidates were gathered. Reset whenever the bounds
+             * buffer, spatial index or hierarchy changes.
+             */
+            std::optional<InputBounds> hoverWindow{};
+
+            /**
+             * \brief Indices of elements that could be hit inside of the hover window, in hit-test order.
+             */
+            std::pmr::vector<uint32_t> hoverCandidates{};
+
+            /**
+             * \brief Global bounds of each hover candidate, clipped by ancestors in the Hierarchy mode.
+             */
+            std::pmr::vector<InputBounds> hoverCandidateBounds{};
+
+            /**
+             * \brief State of the current hit-test pass.
+             */
+            bool scanning = false;
+
+            bool stillInside = false;
+
+            /**
+             * \brief Sorted position of the entered element, if it still contains the pointer. Elements after it are
+             * on the same level or below and do not take over the entered state.
+             */
+            uint32_t enteredPosition = InputHandle::invalidIndex;
+
+            InputElement* target = nullptr;
+
+            InputHandle targetHandle{};
+
+            /**
+             * \brief Hover timer and the element it was started for. Restarted when the pointer moves or enters
+             * another element.
+             */
+            InputTimerHandle hoverTimer{};
+
+            InputHandle hoverTimerElement{};
+
+            /**
+             * \brief Long press timer and the element that was pressed.
+             */
+            InputTimerHandle longPressTimer{};
+
+            InputHandle longPressElement{};
+
+            /**
+             * \brief Last press that did not complete a double click.
+             */
+            InputHandle lastPressElement{};
+
+            MouseButton lastPressButton = MouseButton::Left;
+
+            int64_t lastPressTime = 0;
+        };
+
+        /**
+         * \brief Timer scheduled by the context, either for a pointer or by scheduleTimer.
+         */
+        struct Timer
+        {
+            enum class Type : uint8_t
+            {
+                Hover     = 0,
+                LongPress = 1,
+                Element   = 2,
+                KeyRepeat = 3
+            };
+
+            Type type = Type::Element;
+
+            InputHandle element{};
+
+            uint32_t pointer = mousePointer;
+
+            MouseButton button = MouseButton::Left;
+
+            MouseModifiers modifiers{};
+
+            int32_t key = 0;
+
+            int32_t scancode = 0;
+
+            uint64_t data = 0;
+        };
+
+        /**
+         * \brief Raw cursor or scroll event kept for the sample history.
+         */
+        struct Sample
+        {
+            InputSample sample;
+
+            InputEvent::Type type = InputEvent::Type::Cursor;
+
+            uint32_t pointer = mousePointer;
+        };
+
+        /**
+         * \brief Outcome of testing a single element for a scanning pointer.
+         */
+        enum class ScanOutcome : uint8_t
+        {
+            /**
+             * \brief Element is the entered element. Nothing was tested.
+             */
+            Skip,
+
+            /**
+             * \brief Element does not contain the pointer.
+             */
+            Miss,
+
+            /**
+             * \brief Element is below the entered element, which still contains the pointer. The scan is finished.
+             */
+            Stop,
+
+            /**
+             * \brief Element contains the pointer. The scan is finished.
+             */
+            Hit
+        };
+
+        /**
+         * \brief Result of a chunk of a parallel scan. Aligned to avoid false sharing between workers.
+         */
+        struct alignas(64) ScanChunk
+        {
+            ScanOutcome outcome = ScanOutcome::Miss;
+
+            size_t index = 0;
+
+            uint64_t intersectCalls = 0;
+
+            uint64_t shapeTests = 0;
+
+            uint64_t compareCalls = 0;
+        };
+
+        /**
+         * \brief Results of a chunk of a batched point query.
+         */
+        struct QueryChunk
+        {
+            std::pmr::vector<InputHandle> handles;
+
+            /**
+             * \brief Number of handles per point.
+             */
+            std::pmr::vector<uint32_t> counts;
+
+            std::pmr::vector<uint32_t> candidates;
+        };
+
+        /**
+         * \brief Forwards to the memory resource of the context, counting the allocations made during prePoll and
+         * postPoll.
+         */
+        class AllocationCounter final : public std::pmr::memory_resource
+        {
+        public:
+            explicit AllocationCounter(std::pmr::memory_resource* resource) noexcept;
+
+            std::pmr::memory_resource* upstream = nullptr;
+
+            /**
+             * \brief Number of allocations since active was set.
+             */
+            std::atomic<size_t> allocations = 0;
+
+            /**
+             * \brief If true, the context is in prePoll or postPoll.
+             */
+            bool active = false;
+
+            /**
+             * \brief If true, allocations while active fail an assertion.
+             */
+            bool check = false;
+
+        private:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+
+            void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+            [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+        };
+
+        /**
+         * \brief Dispatch an event to an element and, if propagation is enabled, its listening ancestors.
+         * \tparam F Callable taking the receiving element, its handle and the phase, returning true to stop
+         * propagation.
+         * \param elem Target element.
+         * \param handle Handle of target element.
+         * \param dispatch Callable.
+         */
+        template<typename F>
+        void propagate(InputElement& elem, InputHandle handle, F&& dispatch);
+
+        /**
+         * \brief Drop removed elements, restore the layer order and update the tree, transforms and bounds if needed.
+         */
+        void updateElements();
+
+        /**
+         * \brief Restore the layer order. With UpdateMode::Explicit and an up-to-date tree, only invalidated elements
+         * and their descendants are sorted again, and the positions whose element changed are gathered for
+         * updateBounds. Otherwise, all elements are, and the tree and bounds are rebuilt.
+         */
+        void updateOrder();
+
+        /**
+         * \brief Gather the offsets of all sorted elements.
+         */
+        void gatherOffsets();
+
+        /**
+         * \brief Rebuild the bounds buffer, shape buffer, spatial index or hierarchy from all sorted elements.
+         */
+        void rebuildBounds();
+
+        /**
+         * \brief Update the bounds buffer, shape buffer, spatial index or hierarchy in place for the elements that were
+         * added, removed, moved in the sorted list or had their bounds or offset invalidated.
+         */
+        void updateBounds();
+
+        /**
+         * \brief Mark the scene as changed, so that the element under the cursor is resolved again.
+         */
+        void markSceneChanged() noexcept;
+
+        /**
+         * \brief Gather the hover window around a pointer and the elements that could be hit inside of it.
+         * \param pointer Pointer.
+         */
+        void updateHoverWindow(Pointer& pointer);
+
+        /**
+         * \brief Get the state of a pointer, creating it if it does not exist yet.
+         * \param id Pointer ID.
+         * \return Pointer. Only valid until the next pointer is created.
+         */
+        [[nodiscard]] Pointer& getPointer(uint32_t id);
+
+        [[nodiscard]] const Pointer* findPointer(uint32_t id) const noexcept;
+
+        /**
+         * \brief Get the global transform of an element, from the cache if enabled.
+         * \param elem Element.
+         * \param handle Handle of element.
+         * \return Transform.
+         */
+        [[nodiscard]] InputTransform getTransform(const InputElement& elem, InputHandle handle) const noexcept;
+
+        /**
+         * \brief Returns whether statistics are supported and enabled.
+         * \return True if statistics should be collected.
+         */
+        [[nodiscard]] bool collectStats() const noexcept;
+
+        /**
+         * \brief Add to a metric of the current frame, if statistics are collected.
+         * \param metric Metric.
+         * \param value Value.
+         */
+        void addStat(InputMetric metric, uint64_t value = 1) noexcept;
+
+        /**
+         * \brief Record the statistics of the current frame and start a new one.
+         */
+        void recordStats() noexcept;
+
+        /**
+         * \brief Returns whether the latency of events is measured, i.e. statistics are collected or a tracer is set.
+         * \return True if latency is measured.
+         */
+        [[nodiscard]] bool traceLatency() const noexcept;
+
+        /**
+         * \brief Get the source timestamp for an event that is submitted now.
+         * \return Timestamp or 0.
+         */
+        [[nodiscard]] int64_t stamp() const noexcept;
+
+        /**
+         * \brief Record the latency of an event that was dispatched, if it has a source timestamp.
+         * \param type Event type.
+         * \param pointer Pointer of event.
+         * \param source Source timestamp of event.
+         * \param start Time at which dispatching started.
+         */
+        void traceEvent(InputLatency type, uint32_t pointer, int64_t source, int64_t start);
+
+        /**
+         * \brief Count dispatched events for the frame summary and statistics.
+         * \param count Number of events.
+         */
+        void countDispatched(uint64_t count = 1) noexcept;
+
+        /**
+         * \brief Add an element whose hover, claim or focus state changed to the frame summary.
+         * \param elem Element.
+         * \param handle Handle of element.
+         */
+        void markChanged(const InputElement& elem, InputHandle handle);
+
+        /**
+         * \brief Publish everything changed since the previous poll in the frame summary.
+         */
+        void publishSummary();
+
+        /**
+         * \brief Queue an event, merging it with a queued event if allowed by the coalesce policy.
+         * \param event Event.
+         */
+        void pushEvent(const InputEvent& event) noexcept;
+
+        /**
+         * \brief Get the total capacity of all producers.
+         * \return Capacity.
+         */
+        [[nodiscard]] size_t getProducerCapacity() const noexcept;
+
+        /**
+         * \brief Get the samples of a pointer and type from a range of the sample buffer.
+         * \param type Cursor or Scroll.
+         * \param pointer Pointer ID.
+         * \param begin Start of the range.
+         * \param end End of the range.
+         * \param offset Precise offset subtracted from the values, to move cursor positions into local space.
+         * \return Samples. Valid until the next call.
+         */
+        [[nodiscard]] std::span<const InputSample> gatherSamples(
+          InputEvent::Type type, uint32_t pointer, uint32_t begin, uint32_t end, math::int2 offset = {});
+
+        /**
+         * \brief Resolve the elements under all pending pointers, dispatching enter, exit and move events.
+         */
+        void resolvePointers();
+
+        /**
+         * \brief Handle everything that does not require hit-testing other elements: reusing the last resolution,
+         * exiting the window, exiting the entered element and re-entering the claimed element.
+         * \param pointer Pointer.
+         * \return True if the pointer must be hit-tested against other elements.
+         */
+        [[nodiscard]] bool prepareHover(Pointer& pointer);
+
+        /**
+         * \brief Find the element to enter for all scanning pointers, in a single pass over the elements if possible.
+         */
+        void scanHover();
+
+        /**
+         * \brief Test a single element for a scanning pointer.
+         * \param pointer Pointer.
+         * \param index Index of element in the layer order.
+         * \return True if the scan of the pointer is finished.
+         */
+        [[nodiscard]] bool scanElement(Pointer& pointer, size_t index);
+
+        /**
+         * \brief Test a single element for a scanning pointer without modifying any state, so that it can be called
+         * from worker threads.
+         * \param pointer Pointer.
+         * \param index Index of element in the layer order.
+         * \return Outcome.
+         */
+        [[nodiscard]] ScanOutcome testElement(const Pointer& pointer, size_t index) const noexcept;
+
+        /**
+         * \brief Returns whether an element is tested against its built-in shape instead of calling
+         * InputElement::intersect.
+         * \param index Index of element in the layer order.
+         * \return True if element has a shape.
+         */
+        [[nodiscard]] bool hasShape(size_t index) const noexcept;
+
+        /**
+         * \brief Apply changes to elements made since the last poll, so that queries see the current scene.
+         */
+        void prepareQuery();
+
+        /**
+         * \brief Append the handles of all elements that contain a point, in layer order. Does not modify any state, so
+         * that it can be called from worker threads.
+         * \tparam Handles List of InputHandle.
+         * \param point Point in global space.
+         * \param limit Maximum number of handles to append.
+         * \param scratch List for candidates of a spatial index or hierarchy query.
+         * \param handles List to append handles to.
+         * \return Number of appended handles.
+         */
+        template<typename Handles>
+        size_t queryPoint(math::int2 point, size_t limit, std::pmr::vector<uint32_t>& scratch, Handles& handles) const;
+
+        /**
+         * \brief Test a point against a single element, using its built-in shape if it has one.
+         * \param index Index of element in the layer order.
+         * \param point Point in global space.
+         * \return True if the element contains the point.
+         */
+        [[nodiscard]] bool containsPoint(size_t index, math::int2 point) const noexcept;
+
+        /**
+         * \brief Add the calls made by testElement to the statistics.
+         * \param pointer Pointer.
+         * \param index Index of element in the layer order.
+         * \param outcome Outcome of testElement.
+         */
+        void addScanStats(const Pointer& pointer, size_t index, ScanOutcome outcome) noexcept;
+
+        /**
+         * \brief Get the number of blocks of the shape buffer that can hold an element above the entered element.
+         * \param pointer Pointer.
+         * \return Number of blocks.
+         */
+        [[nodiscard]] size_t scannedBlocks(const Pointer& pointer) const noexcept;
+
+        /**
+         * \brief Returns whether a number of elements should be hit-tested on the worker pool.
+         * \param count Number of elements.
+         * \return True if parallel.
+         */
+        [[nodiscard]] bool scanInParallel(size_t count) const noexcept;
+
+        /**
+         * \brief Find the element to enter for a scanning pointer on the worker pool. The elements are split into a
+         * sequence of units (e.g. elements or blocks), which are divided into chunks.
+         * \tparam Visit Callable taking a unit index and a callable taking an element index. Must pass the elements of
+         * the unit in order until the callable returns true.
+         * \param pointer Pointer.
+         * \param unitCount Number of units.
+         * \param visit Visitor.
+         */
+        template<typename Visit>
+        void scanParallel(Pointer& pointer, size_t unitCount, const Visit& visit);
+
+        void mouseMoveEvents(Pointer& pointer);
+
+        void mouseClickEvents(Pointer& pointer, const MouseClickEvent& click, int64_t t);
+
+        /**
+         * \brief Restart or cancel the hover and long press timers of a pointer after it was resolved.
+         * \param pointer Pointer.
+         */
+        void updatePointerTimers(Pointer& pointer);
+
+        /**
+         * \brief Dispatch events for all timers that expire at or before a time.
+         * \param t Time.
+         */
+        void fireTimers(int64_t t);
+
+        void mouseScrollEvents(Pointer& pointer, const InputEvent& event);
+
+        /**
+         * \brief Dispatch a key event to the focused element, start or stop key repeat and handle tab traversal.
+         * \param key Key.
+         * \param t Time of the event.
+         */
+        void keyEvents(const KeyEvent& key, int64_t t);
+
+        void textEvents(std::span<const char32_t> codepoints);
+
+        /**
+         * \brief Move keyboard focus, dispatching exit and enter events.
+         * \param elem Element or nullptr.
+         * \param handle Handle of element.
+         */
+        void changeFocus(InputElement* elem, InputHandle handle);
+
+        /**
+         * \brief Move keyboard focus to a neighbour in the focus chain.
+         * \param forward Direction.
+         * \return True if focus moved.
+         */
+        bool focusNeighbour(bool forward);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief All memory of the context is allocated from this counter. Containers that live as long as the
+         * elements or pointers they describe use the element pool, and scratch space that is only needed during a
+         * single call uses the frame arena. Both keep their memory once it was allocated.
+         */
+        AllocationCounter allocationCounter;
+
+        std::pmr::unsynchronized_pool_resource elementPool;
+
+        InputArena frameArena;
+
+        int64_t time = 0;
+
+        bool focus = false;
+
+        /**
+         * \brief All input elements, by handle.
+         */
+        InputElementRegistry elementRegistry;
+
+        /**
+         * \brief All input elements, sorted by layer descending.
+         */
+        InputLayerOrder inputElements;
+
+        /**
+         * \brief If true, elements were added or removed since the last update of the layer order.
+         */
+        bool elementsDirty = false;
+
+        HitTestMode hitTestMode = HitTestMode::Linear;
+
+        /**
+         * \brief Tree of all input elements. Not kept up-to-date with UpdateMode::Poll and HitTestMode::Linear, unless
+         * needed by the transform cache or propagation.
+         */
+        InputTree tree;
+
+        /**
+         * \brief If true, the tree must be rebuilt. Otherwise, it is kept up-to-date as elements are added, removed and
+         * reparented with UpdateMode::Explicit.
+         */
+        bool treeDirty = true;
+
+        bool transformCacheEnabled = false;
+
+        InputTransformCache transforms;
+
+        bool propagationEnabled = false;
+
+        /**
+         * \brief If true, the propagation of an element was invalidated, so that paths must be rebuilt.
+         */
+        bool propagationDirty = false;
+
+        InputPropagationPaths propagationPaths;
+
+        /**
+         * \brief Copy of the path of the event that is being propagated, as handlers can cause paths to be rebuilt.
+         */
+        std::pmr::vector<InputPropagationPaths::Entry> propagationPath;
+
+        /**
+         * \brief Offsets of all sorted elements, gathered while rebuilding bounds.
+         */
+        std::pmr::vector<math::int2> offsets;
+
+        /**
+         * \brief If true, the bounds buffer, spatial index or hierarchy must be rebuilt.
+         */
+        bool boundsDirty = true;
+
+        /**
+         * \brief Elements whose bounds were invalidated since the last update. Ignored if boundsDirty is set.
+         */
+        std::pmr::vector<const InputElement*> dirtyBounds;
+
+        /**
+         * \brief Elements whose offset was invalidated since the last update. Their descendants moved as well. Ignored
+         * if boundsDirty is set.
+         */
+        std::pmr::vector<const InputElement*> dirtyOffsets;
+
+        /**
+         * \brief Elements removed since the last update. Ignored if boundsDirty is set.
+         */
+        std::pmr::vector<InputHandle> removedHandles;
+
+        /**
+         * \brief Positions whose element changed in the layer order since the last update. Ignored if boundsDirty is
+         * set.
+         */
+        InputLayerOrder::Range changedPositions;
+
+        /**
+         * \brief If true, elements were added or reparented since the last update, so that the hierarchy must be
+         * rebuilt.
+         */
+        bool hierarchyDirty = false;
+
+        UpdateMode updateMode = UpdateMode::Poll;
+
+        /**
+         * \brief If true, elements were added, removed or invalidated since the last poll, so the element under the
+         * cursor must be resolved again.
+         */
+        bool sceneChanged = true;
+
+        InputBoundsBuffer boundsBuffer;
+
+        /**
+         * \brief Built-in shapes of elements. Used in all hit-test modes except Linear.
+         */
+        InputShapeBuffer shapeBuffer;
+
+        InputSpatialIndex spatialIndex;
+
+        InputHierarchy hierarchy;
+
+        /**
+         * \brief Indices of elements returned by the last spatial index or hierarchy query.
+         */
+        std::pmr::vector<uint32_t> candidates;
+
+        int32_t hoverCacheRadius = 16;
+
+        /**
+         * \brief State of all pointers that were ever used. The mouse pointer is always first.
+         */
+        std::pmr::vector<Pointer> pointers;
+
+        /**
+         * \brief Indices of pointers that are hit-tested in the current pass.
+         */
+        std::pmr::vector<size_t> scanningPointers;
+
+        /**
+         * \brief Capacity of the event queue set with setEventCapacity, excluding the capacity of producers.
+         */
+        size_t eventCapacity = 256;
+
+        /**
+         * \brief Events submitted since the last poll.
+         */
+        InputRingBuffer<InputEvent> events;
+
+        CoalescePolicy coalescePolicy;
+
+        size_t droppedEvents = 0;
+
+        std::vector<std::unique_ptr<InputProducer>> producers;
+
+        InputRecorder* recorder = nullptr;
+
+        InputTracer* tracer = nullptr;
+
+        /**
+         * \brief Source timestamp of submitted events, or 0 to stamp them when submitted.
+         */
+        int64_t timestamp = 0;
+
+        /**
+         * \brief Spans of the events dispatched during the current frame.
+         */
+        std::pmr::vector<InputEventTrace> traceEvents;
+
+        InputWorkerPool* workerPool = nullptr;
+
+        size_t parallelThreshold = 32768;
+
+        /**
+         * \brief Results of the chunks of the last parallel scan.
+         */
+        std::pmr::vector<ScanChunk> scanChunks;
+
+        /**
+         * \brief Results of the chunks of the last parallel batched query.
+         */
+        std::pmr::vector<QueryChunk> queryChunks;
+
+        /**
+         * \brief Bounds of candidates returned by the last region query.
+         */
+        std::pmr::vector<InputBounds> queryBounds;
+
+        /**
+         * \brief Handles of the elements removed by the last call to removeSubtree.
+         */
+        std::pmr::vector<InputHandle> subtreeHandles;
+
+        InputTimerWheel<Timer> timers;
+
+        /**
+         * \brief Timers that expired during the last call to fireTimers.
+         */
+        std::pmr::vector<InputTimerWheel<Timer>::Expired> expiredTimers;
+
+        int64_t hoverDelay = 0;
+
+        int64_t longPressDelay = 0;
+
+        int64_t doubleClickInterval = 0;
+
+        int64_t keyRepeatDelay = 0;
+
+        int64_t keyRepeatInterval = 0;
+
+        /**
+         * \brief Key repeat timer and the key that is repeated.
+         */
+        InputTimerHandle keyRepeatTimer{};
+
+        int32_t keyRepeatKey = 0;
+
+        /**
+         * \brief Focusable elements in tab order.
+         */
+        InputFocusChain focusChain;
+
+        /**
+         * \brief Element that has keyboard focus. Cleared when the element is removed.
+         */
+        InputElement* focusedElement = nullptr;
+
+        InputHandle focusedHandle{};
+
+        int32_t tabKey = defaultTabKey;
+
+        /**
+         * \brief Codepoints of the queued text events.
+         */
+        std::pmr::vector<char32_t> text;
+
+        /**
+         * \brief Raw cursor and scroll events queued since the last poll, if CoalescePolicy::history is enabled.
+         */
+        std::pmr::vector<Sample> samples;
+
+        /**
+         * \brief Samples returned by the last call to gatherSamples.
+         */
+        std::pmr::vector<InputSample> gatheredSamples;
+
+        /**
+         * \brief Summary of the last poll.
+         */
+        FrameSummary frameSummary;
+
+        /**
+         * \brief Number of events dispatched since the last poll.
+         */
+        size_t dispatchedEvents = 0;
+
+        /**
+         * \brief Elements marked as changed since the last poll.
+         */
+        std::pmr::vector<InputHandle> changedElements;
+
+        /**
+         * \brief Changed elements of the last poll, referred to by the frame summary.
+         */
+        std::pmr::vector<InputHandle> summaryElements;
+
+        std::optional<InputBounds> damage;
+
+        bool unboundedDamage = false;
+
+        /**
+         * \brief Index of the summary in which each element was last marked as changed, by handle index.
+         */
+        std::pmr::vector<uint64_t> changedSummaries;
+
+        uint64_t summaryIndex = 1;
+
+        /**
+         * \brief Signal notified by producers and wake.
+         */
+        InputSignal signal;
+
+        bool statsEnabled = false;
+
+        InputStats stats;
+
+        /**
+         * \brief Statistics of the current frame.
+         */
+        InputFrameStats frameStats;
+
+        /**
+         * \brief Total number of dropped events at the end of the previous frame.
+         */
+        size_t statsDroppedEvents = 0;
+    };
+
+    [[nodiscard]] constexpr InputContext::Invalidate operator|(const InputContext::Invalidate lhs,
+                                                               const InputContext::Invalidate rhs) noexcept
+    {
+        return static_cast<InputContext::Invalidate>(static_cast<uint32_t>(lhs) | static_cast<uint32_t>(rhs));
+    }
+
+    [[nodiscard]] constexpr InputContext::Invalidate operator&(const InputContext::Invalidate lhs,
+                                                               const InputContext::Invalidate rhs) noexcept
+    {
+        return static_cast<InputContext::Invalidate>(static_cast<uint32_t>(lhs) & static_cast<uint32_t>(rhs));
+    }
 }  // namespace floah
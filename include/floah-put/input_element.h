@@ -5,12 +5,15 @@
 ////////////////////////////////////////////////////////////////
 
 #include <cstdint>
+#include <optional>
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "floah-put/input_bounds.h"
 #include "floah-put/input_context.h"
+#include "floah-put/input_shape.h"
 
 namespace floah
 {
@@ -56,6 +59,53 @@ namespace floah
          */
         [[nodiscard]] virtual math::int2 getInputOffset() const noexcept;
 
+        /**
+         * \brief Optional bounding box of this input element in local space (i.e. before applying the input offset).
+         * If set, intersect must return false for all points outside of it. Used by the input context to skip
+         * elements during hit-testing. Defaults to the bounds of the shape (see getInputShape).
+         * \return Bounds or std::nullopt.
+         */
+        [[nodiscard]] virtual std::optional<InputBounds> getInputBounds() const noexcept;
+
+        /**
+         * \brief Returns whether the descendants of this input element can only be hit inside of its bounds (see
+         * getInputBounds), e.g. because this element is a scroll view. Allows the input context to skip testing all
+         * descendants when a point is outside of the bounds.
+         * \return True if descendants are clipped.
+         */
+        [[nodiscard]] virtual bool getInputClipChildren() const noexcept;
+
+        /**
+         * \brief Optional built-in hit shape of this input element in local space. If set, the input context tests
+         * points against the shape instead of calling intersect (except in the Linear hit-test mode). The shape must
+         * be inside of the bounds, if those are overridden.
+         * \return Shape or std::nullopt.
+         */
+        [[nodiscard]] virtual std::optional<InputShape> getInputShape() const noexcept;
+
+        /**
+         * \brief Returns whether this input element can receive keyboard focus through tab traversal or by being
+         * clicked. The input context must be notified of changes with InputContext::Invalidate::Focus.
+         * \return True if focusable.
+         */
+        [[nodiscard]] virtual bool getInputFocusable() const noexcept;
+
+        /**
+         * \brief Get the tab index. Focusable elements are traversed by tab index ascending, and elements with the
+         * same tab index in the order in which they were added to the context.
+         * \return Tab index.
+         */
+        [[nodiscard]] virtual int32_t getInputTabIndex() const noexcept;
+
+        /**
+         * \brief Returns in which phases this input element receives the click and scroll events of its descendants,
+         * e.g. so that a container can intercept clicks or a scroll view can handle scroll events that its children did
+         * not consume. Only used if propagation is enabled (see InputContext::setPropagationEnabled). The input context
+         * must be notified of changes with InputContext::Invalidate::Propagation.
+         * \return Propagation.
+         */
+        [[nodiscard]] virtual InputContext::Propagation getInputPropagation() const noexcept;
+
         ////////////////////////////////////////////////////////////////
         // Input.
         ////////////////////////////////////////////////////////////////
@@ -68,11 +118,13 @@ namespace floah
         [[nodiscard]] bool compare(const InputElement& other) const noexcept;
 
         /**
-         * \brief Returns whether point is inside of element.
+         * \brief Returns whether point is inside of element. If the context has a worker pool (see
+         * InputContext::setWorkerPool), this can be called concurrently for different elements. Defaults to testing
+         * the shape (see getInputShape).
          * \param point Point.
          * \return True if point is inside.
          */
-        [[nodiscard]] virtual bool intersect(math::int2 point) const noexcept = 0;
+        [[nodiscard]] virtual bool intersect(math::int2 point) const noexcept;
 
         ////////////////////////////////////////////////////////////////
         // Events.
@@ -113,5 +165,66 @@ namespace floah
          */
         [[nodiscard]] virtual InputContext::MouseScrollResult
           onMouseScroll(const InputContext::MouseScrollEvent& scroll);
+
+        /**
+         * \brief Mouse hover event. Called when the mouse rested over this input element for the hover delay.
+         * \param hover Event properties.
+         * \return Event results.
+         */
+        [[nodiscard]] virtual InputContext::MouseHoverResult onMouseHover(const InputContext::MouseHoverEvent& hover);
+
+        /**
+         * \brief Long press event. Called when a button was held down on this input element for the long press delay.
+         * \param press Event properties.
+         * \return Event results.
+         */
+        [[nodiscard]] virtual InputContext::LongPressResult onLongPress(const InputContext::LongPressEvent& press);
+
+        /**
+         * \brief Double click event. Called when a button was pressed twice on this input element within the double
+         * click interval.
+         * \param click Event properties.
+         * \return Event results.
+         */
+        [[nodiscard]] virtual InputContext::DoubleClickResult
+          onDoubleClick(const InputContext::DoubleClickEvent& click);
+
+        /**
+         * \brief Timer event. Called when a timer scheduled for this input element with InputContext::scheduleTimer
+         * expired.
+         * \param timer Event properties.
+         * \return Event results.
+         */
+        [[nodiscard]] virtual InputContext::TimerResult onTimer(const InputContext::TimerEvent& timer);
+
+        /**
+         * \brief Focus enter event. Called when this input element receives keyboard focus.
+         * \param focus Event properties.
+         * \return Event results.
+         */
+        [[nodiscard]] virtual InputContext::FocusEnterResult onFocusEnter(const InputContext::FocusEnterEvent& focus);
+
+        /**
+         * \brief Focus exit event. Called when this input element loses keyboard focus.
+         * \param focus Event properties.
+         * \return Event results.
+         */
+        [[nodiscard]] virtual InputContext::FocusExitResult onFocusExit(const InputContext::FocusExitEvent& focus);
+
+        /**
+         * \brief Key event. Called when a key is pressed, repeated or released while this input element has keyboard
+         * focus.
+         * \param key Event properties.
+         * \return Event results.
+         */
+        [[nodiscard]] virtual InputContext::KeyResult onKey(const InputContext::KeyEvent& key);
+
+        /**
+         * \brief Text event. Called with all consecutive text input (e.g. typed characters, a paste or an IME commit)
+         * while this input element has keyboard focus.
+         * \param text Event properties.
+         * \return Event results.
+         */
+        [[nodiscard]] virtual InputContext::TextResult onText(const InputContext::TextEvent& text);
     };
 }  // namespace floah
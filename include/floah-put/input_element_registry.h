@@ -0,0 +1,153 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_handle.h"
+
+namespace floah
+{
+    class InputElement;
+
+    /**
+     * \brief Slot map of input elements. Adding, removing and looking up elements by handle or by element is O(1).
+     * Elements are stored densely; removing an element moves the last element into its place, so the dense order is
+     * not stable.
+     */
+    class InputElementRegistry
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty registry.
+         * \param resource Resource to allocate slots and the lookup table from.
+         */
+        explicit InputElementRegistry(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        InputElementRegistry(const InputElementRegistry&) = delete;
+
+        InputElementRegistry(InputElementRegistry&&) noexcept = delete;
+
+        ~InputElementRegistry() noexcept;
+
+        InputElementRegistry& operator=(const InputElementRegistry&) = delete;
+
+        InputElementRegistry& operator=(InputElementRegistry&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * \brief Get the number of slots. All valid handles have an index smaller than this.
+         * \return Number of slots.
+         */
+        [[nodiscard]] size_t getSlotCount() const noexcept;
+
+        /**
+         * \brief Get all elements, in no particular order.
+         * \return Elements.
+         */
+        [[nodiscard]] std::span<InputElement* const> getElements() const noexcept;
+
+        /**
+         * \brief Get the handles of all elements, in the same order as getElements.
+         * \return Handles.
+         */
+        [[nodiscard]] std::span<const InputHandle> getHandles() const noexcept;
+
+        /**
+         * \brief Returns whether a handle refers to an element in this registry.
+         * \param handle Handle.
+         * \return True if handle is valid.
+         */
+        [[nodiscard]] bool contains(InputHandle handle) const noexcept;
+
+        /**
+         * \brief Get the element a handle refers to.
+         * \param handle Handle.
+         * \return Element or nullptr if the handle is not valid.
+         */
+        [[nodiscard]] InputElement* get(InputHandle handle) const noexcept;
+
+        /**
+         * \brief Get the handle of an element.
+         * \param elem Element.
+         * \return Handle, or invalid handle if element is not in this registry.
+         */
+        [[nodiscard]] InputHandle find(const InputElement& elem) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Elements.
+        ////////////////////////////////////////////////////////////////
+
+        void reserve(size_t count);
+
+        /**
+         * \brief Add an element.
+         * \param elem Element.
+         * \return New handle, or the existing handle if the element was already added.
+         */
+        InputHandle add(InputElement& elem);
+
+        /**
+         * \brief Remove an element.
+         * \param handle Handle.
+         * \return True if element was removed, false if the handle is not valid.
+         */
+        bool remove(InputHandle handle);
+
+    private:
+        struct Slot
+        {
+            /**
+             * \brief Index in the dense arrays.
+             */
+            uint32_t dense = 0;
+
+            uint32_t generation = 0;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::pmr::vector<Slot> slots;
+
+        /**
+         * \brief Indices of unused slots.
+         */
+        std::pmr::vector<uint32_t> freeSlots;
+
+        /**
+         * \brief Dense list of elements.
+         */
+        std::pmr::vector<InputElement*> elements;
+
+        /**
+         * \brief Dense list of handles.
+         */
+        std::pmr::vector<InputHandle> handles;
+
+        /**
+         * \brief Slot index by element.
+         */
+        std::pmr::unordered_map<const InputElement*, uint32_t> lookup;
+    };
+}  // namespace floah
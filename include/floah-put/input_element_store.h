@@ -0,0 +1,411 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_bounds.h"
+#include "floah-put/input_context.h"
+#include "floah-put/input_element.h"
+
+namespace floah
+{
+    /**
+     * \brief Requirements for elements stored in an InputElementStore. Only intersect is required. Optional members
+     * are detected at compile time:
+     *   - math::int2 getInputOffset() const: offset relative to the store. Defaults to zero.
+     *   - InputBounds getInputBounds() const: bounds relative to the element, used by InputElementStore::updateBounds.
+     *   - onMouseEnter, onMouseExit, onMouseClick, onMouseMove and onMouseScroll, with the same signatures as the
+     *     InputElement handlers. Events for which no handler exists are not delivered.
+     * None of these need to be virtual. Making the type final (or not polymorphic at all) allows the store to inline
+     * all calls.
+     */
+    template<typename T>
+    concept StaticInputElement = requires(const T& elem, math::int2 point) {
+        { elem.intersect(point) } -> std::convertible_to<bool>;
+    };
+
+    /**
+     * \brief Contiguous store of input elements of a single concrete type, which is itself added to an InputContext
+     * as a single InputElement. Hit-testing and dispatching to stored elements is done by a loop over the elements
+     * without virtual calls, so that large homogeneous sets (e.g. thousands of cells in a grid) are cheap.
+     *
+     * Stored elements are siblings inside of the store: elements with a higher index are on top of elements with a
+     * lower index. The store's own parent, layer, offset and bounds place it among the other elements of the context.
+     * Enter, exit and claim semantics between stored elements mirror those of the context. Stored elements are driven
+     * by a single pointer at a time: the first pointer to enter the store. Events of other pointers are ignored until
+     * that pointer has exited the store and released its claim.
+     * \tparam T Element type.
+     */
+    template<StaticInputElement T>
+    class InputElementStore final : public InputElement
+    {
+    public:
+        static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InputElementStore() = default;
+
+        InputElementStore(const InputElementStore&) = delete;
+
+        InputElementStore(InputElementStore&&) noexcept = delete;
+
+        ~InputElementStore() noexcept override = default;
+
+        InputElementStore& operator=(const InputElementStore&) = delete;
+
+        InputElementStore& operator=(InputElementStore&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] const InputElement* getInputParent() const noexcept override { return parent; }
+
+        [[nodiscard]] int32_t getInputLayer() const noexcept override { return layer; }
+
+        [[nodiscard]] math::int2 getInputOffset() const noexcept override
+        {
+            return parent ? parent->getInputOffset() + offset : offset;
+        }
+
+        [[nodiscard]] std::optional<InputBounds> getInputBounds() const noexcept override { return bounds; }
+
+        [[nodiscard]] size_t size() const noexcept { return elements.size(); }
+
+        [[nodiscard]] T& operator[](const size_t index) noexcept { return elements[index]; }
+
+        [[nodiscard]] const T& operator[](const size_t index) const noexcept { return elements[index]; }
+
+        /**
+         * \brief Get the index of the element the cursor is currently over.
+         * \return Index or none.
+         */
+        [[nodiscard]] size_t getHovered() const noexcept { return hovered; }
+
+        /**
+         * \brief Get the index of the element that has claimed input.
+         * \return Index or none.
+         */
+        [[nodiscard]] size_t getClaimed() const noexcept { return claimed; }
+
+        /**
+         * \brief Find the topmost element containing a point.
+         * \param point Point in the local space of the store.
+         * \return Index or none.
+         */
+        [[nodiscard]] size_t find(const math::int2 point) const noexcept
+        {
+            for (size_t i = elements.size(); i-- > 0;)
+                if (elements[i].intersect(point - getOffset(elements[i]))) return i;
+            return none;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        void setInputParent(const InputElement* p) noexcept { parent = p; }
+
+        void setInputLayer(const int32_t l) noexcept { layer = l; }
+
+        /**
+         * \brief Set the offset of the store relative to its parent.
+         * \param o Offset.
+         */
+        void setInputOffset(const math::int2 o) noexcept { offset = o; }
+
+        /**
+         * \brief Set the bounds of the store, in its local space. Must contain all stored elements.
+         * \param b Bounds or std::nullopt.
+         */
+        void setInputBounds(const std::optional<InputBounds> b) noexcept { bounds = b; }
+
+        ////////////////////////////////////////////////////////////////
+        // Elements.
+        ////////////////////////////////////////////////////////////////
+
+        void reserve(const size_t count) { elements.reserve(count); }
+
+        /**
+         * \brief Construct a new element on top of all other elements.
+         * \tparam Args Argument types.
+         * \param args Constructor arguments.
+         * \return Element.
+         */
+        template<typename... Args>
+        T& emplace(Args&&... args)
+        {
+            return elements.emplace_back(std::forward<Args>(args)...);
+        }
+
+        /**
+         * \brief Remove an element. Elements with a higher index move down by one. The removed element receives no
+         * further events.
+         * \param index Index.
+         */
+        void erase(const size_t index)
+        {
+            const auto fix = [index](size_t& i) {
+                if (i == index)
+                    i = none;
+                else if (i != none && i > index)
+                    i--;
+            };
+            fix(hovered);
+            fix(claimed);
+            elements.erase(elements.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+
+        void clear() noexcept
+        {
+            elements.clear();
+            hovered = none;
+            claimed = none;
+        }
+
+        /**
+         * \brief Set the bounds of the store to the union of the bounds of all elements.
+         */
+        void updateBounds() noexcept
+            requires requires(const T& elem) {
+                { elem.getInputBounds() } -> std::convertible_to<InputBounds>;
+            }
+        {
+            if (elements.empty())
+            {
+                bounds = InputBounds{};
+                return;
+            }
+
+            auto b = static_cast<InputBounds>(elements.front().getInputBounds()).translate(getOffset(elements.front()));
+            for (const auto& elem : elements)
+            {
+                const auto e = static_cast<InputBounds>(elem.getInputBounds()).translate(getOffset(elem));
+                b.lower      = math::int2(std::min(b.lower.x, e.lower.x), std::min(b.lower.y, e.lower.y));
+                b.upper      = math::int2(std::max(b.upper.x, e.upper.x), std::max(b.upper.y, e.upper.y));
+            }
+            bounds = b;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Input.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the pointer that currently drives the stored elements.
+         * \return Pointer ID, or the ID of the last pointer that did if there is none.
+         */
+        [[nodiscard]] uint32_t getPointer() const noexcept { return pointer; }
+
+        /**
+         * \brief Returns whether any element contains the point.
+         * \param point Point.
+         * \return True if point is inside.
+         */
+        [[nodiscard]] bool intersect(const math::int2 point) const noexcept override { return find(point) != none; }
+
+        ////////////////////////////////////////////////////////////////
+        // Events.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] InputContext::MouseEnterResult onMouseEnter(const InputContext::MouseEnterEvent& enter) override
+        {
+            if (!owns(enter.pointer)) return {};
+            pointer = enter.pointer;
+            inside  = true;
+            hover(resolve(enter.position));
+            return {};
+        }
+
+        [[nodiscard]] InputContext::MouseExitResult onMouseExit(const InputContext::MouseExitEvent& exit) override
+        {
+            if (exit.pointer != pointer) return {};
+            inside = false;
+            hover(none);
+            return {};
+        }
+
+        [[nodiscard]] InputContext::MouseClickResult onMouseClick(const InputContext::MouseClickEvent& click) override
+        {
+            if (click.pointer != pointer) return {};
+            const auto target = claimed != none ? claimed : hovered;
+            if (target == none) return {};
+
+            if constexpr (requires(T& elem) {
+                              { elem.onMouseClick(click) } -> std::same_as<InputContext::MouseClickResult>;
+                          })
+            {
+                claimed = elements[target].onMouseClick(click).claim ? target : none;
+            }
+
+            return {.claim = claimed != none};
+        }
+
+        [[nodiscard]] InputContext::MouseMoveResult onMouseMove(const InputContext::MouseMoveEvent& move) override
+        {
+            if (move.pointer != pointer) return {};
+
+            // The store stays entered while moving between its elements, so enter and exit are resolved here.
+            hover(resolve(move.current));
+
+            const auto target = claimed != none ? claimed : hovered;
+            if constexpr (requires(T& elem) {
+                              { elem.onMouseMove(move) } -> std::same_as<InputContext::MouseMoveResult>;
+                          })
+            {
+                if (target != none)
+                {
+                    const auto elemOffset    = getOffset(elements[target]);
+                    const auto preciseOffset = InputContext::toPrecise(elemOffset);
+                    samples.assign(move.samples.begin(), move.samples.end());
+                    for (auto& sample : samples) sample.value = sample.value - preciseOffset;
+
+                    auto elemMove            = move;
+                    elemMove.previous        = move.previous - elemOffset;
+                    elemMove.current         = move.current - elemOffset;
+                    elemMove.precisePrevious = move.precisePrevious - preciseOffset;
+                    elemMove.preciseCurrent  = move.preciseCurrent - preciseOffset;
+                    elemMove.samples         = samples;
+                    static_cast<void>(elements[target].onMouseMove(elemMove));
+                }
+            }
+
+            return {};
+        }
+
+        [[nodiscard]] InputContext::MouseScrollResult
+          onMouseScroll(const InputContext::MouseScrollEvent& scroll) override
+        {
+            if (scroll.pointer != pointer) return {};
+            const auto target = claimed != none ? claimed : hovered;
+            if constexpr (requires(T& elem) {
+                              { elem.onMouseScroll(scroll) } -> std::same_as<InputContext::MouseScrollResult>;
+                          })
+            {
+                if (target != none) static_cast<void>(elements[target].onMouseScroll(scroll));
+            }
+
+            return {};
+        }
+
+    private:
+        /**
+         * \brief Returns whether a pointer may drive the stored elements.
+         * \param id Pointer ID.
+         * \return True if the pointer is the current one, or there is no current pointer.
+         */
+        [[nodiscard]] bool owns(const uint32_t id) const noexcept
+        {
+            return id == pointer || (!inside && claimed == none);
+        }
+
+        [[nodiscard]] static math::int2 getOffset(const T& elem) noexcept
+        {
+            if constexpr (requires {
+                              { elem.getInputOffset() } -> std::convertible_to<math::int2>;
+                          })
+                return elem.getInputOffset();
+            else
+                return {};
+        }
+
+        /**
+         * \brief Get the element that should be hovered at a point. While an element has claimed input, only that
+         * element can be hovered, even if it is covered by other elements. The point is remembered to calculate the
+         * position passed to the enter event of the element.
+         * \param point Point in the local space of the store.
+         * \return Index or none.
+         */
+        [[nodiscard]] size_t resolve(const math::int2 point) noexcept
+        {
+            candidate = point;
+            if (claimed == none) return find(point);
+            return elements[claimed].intersect(point - getOffset(elements[claimed])) ? claimed : none;
+        }
+
+        /**
+         * \brief Change the hovered element, sending exit and enter events.
+         * \param index New hovered element or none.
+         */
+        void hover(const size_t index)
+        {
+            if (index == hovered) return;
+
+            if constexpr (requires(T& elem, const InputContext::MouseExitEvent& e) {
+                              { elem.onMouseExit(e) } -> std::same_as<InputContext::MouseExitResult>;
+                          })
+            {
+                if (hovered != none)
+                    static_cast<void>(elements[hovered].onMouseExit(InputContext::MouseExitEvent{.pointer = pointer}));
+            }
+
+            hovered = index;
+
+            if constexpr (requires(T& elem, const InputContext::MouseEnterEvent& e) {
+                              { elem.onMouseEnter(e) } -> std::same_as<InputContext::MouseEnterResult>;
+                          })
+            {
+                if (hovered != none)
+                {
+                    const auto position = candidate - getOffset(elements[hovered]);
+                    static_cast<void>(elements[hovered].onMouseEnter(
+                      InputContext::MouseEnterEvent{.pointer = pointer, .position = position}));
+                }
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::vector<T> elements;
+
+        const InputElement* parent = nullptr;
+
+        int32_t layer = 0;
+
+        math::int2 offset;
+
+        std::optional<InputBounds> bounds;
+
+        size_t hovered = none;
+
+        size_t claimed = none;
+
+        /**
+         * \brief Pointer driving the stored elements.
+         */
+        uint32_t pointer = InputContext::mousePointer;
+
+        /**
+         * \brief If true, the pointer has entered the store and not exited it yet.
+         */
+        bool inside = false;
+
+        /**
+         * \brief Position of the pointer passed to the last call to resolve, in the local space of the store.
+         */
+        math::int2 candidate;
+
+        /**
+         * \brief Samples of the last move, moved from the space of the store into that of the element it is passed to.
+         */
+        std::vector<InputContext::InputSample> samples;
+    };
+}  // namespace floah
@@ -0,0 +1,154 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_handle.h"
+
+namespace floah
+{
+    class InputElement;
+    class InputElementRegistry;
+
+    /**
+     * \brief Keeps the focusable input elements (see InputElement::getInputFocusable) in tab order, i.e. sorted by tab
+     * index (see InputElement::getInputTabIndex) and then by the order in which they were added.
+     *
+     * The chain is only updated when a focusable element was added or removed, or an element was invalidated, so
+     * looking up the position of an element and moving to its neighbour are O(1) and do not query any element.
+     */
+    class InputFocusChain
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty chain.
+         * \param resource Resource to allocate entries from.
+         */
+        explicit InputFocusChain(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        InputFocusChain(const InputFocusChain&) = delete;
+
+        InputFocusChain(InputFocusChain&&) noexcept = delete;
+
+        ~InputFocusChain() noexcept;
+
+        InputFocusChain& operator=(const InputFocusChain&) = delete;
+
+        InputFocusChain& operator=(InputFocusChain&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the handles of all focusable elements, in tab order. Changes since the last update are not yet
+         * included.
+         * \return Handles.
+         */
+        [[nodiscard]] std::span<const InputHandle> getHandles() const noexcept;
+
+        /**
+         * \brief Get the position of an element in the chain.
+         * \param handle Handle of element.
+         * \return Index in getHandles, or InputHandle::invalidIndex if the element is not in the chain.
+         */
+        [[nodiscard]] uint32_t getPosition(InputHandle handle) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Elements.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Add an element. If it is focusable, it is inserted at the right position on the next update.
+         * \param handle Handle of element in registry.
+         * \param elem Element to add.
+         */
+        void add(InputHandle handle, const InputElement& elem);
+
+        /**
+         * \brief Notify the chain that an element was removed from the registry.
+         * \param handle Handle of element.
+         */
+        void remove(InputHandle handle) noexcept;
+
+        /**
+         * \brief Query whether an element is focusable and its tab index again on the next update.
+         * \param handle Handle of element.
+         */
+        void invalidate(InputHandle handle);
+
+        ////////////////////////////////////////////////////////////////
+        // Update.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Drop removed elements and insert added and invalidated elements. Does nothing if nothing changed.
+         * \param registry Registry that elements were added to.
+         * \return True if the chain changed.
+         */
+        bool update(const InputElementRegistry& registry);
+
+    private:
+        struct Entry
+        {
+            InputHandle handle;
+
+            int32_t tabIndex = 0;
+
+            /**
+             * \brief Order in which the element was added.
+             */
+            uint64_t sequence = 0;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Entries in tab order.
+         */
+        std::pmr::vector<Entry> entries;
+
+        /**
+         * \brief Handles in tab order, mirroring entries.
+         */
+        std::pmr::vector<InputHandle> handles;
+
+        /**
+         * \brief Position of each element in the chain by handle index.
+         */
+        std::pmr::vector<uint32_t> positions;
+
+        /**
+         * \brief Order in which each element was added, by handle index.
+         */
+        std::pmr::vector<uint64_t> sequences;
+
+        uint64_t nextSequence = 0;
+
+        /**
+         * \brief Added and invalidated elements that must be queried on the next update.
+         */
+        std::pmr::vector<InputHandle> invalidated;
+
+        /**
+         * \brief If true, the chain must be updated.
+         */
+        bool dirty = false;
+    };
+}  // namespace floah
@@ -0,0 +1,34 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <limits>
+
+namespace floah
+{
+    /**
+     * \brief Stable handle to an input element registered with an InputContext. A handle stays valid until its element
+     * is removed. Handles of removed elements are never reused, because slots are reused with a new generation.
+     */
+    struct InputHandle
+    {
+        static constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * \brief Slot index.
+         */
+        uint32_t index = invalidIndex;
+
+        /**
+         * \brief Generation of the slot at the time the handle was created.
+         */
+        uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const noexcept { return index != invalidIndex; }
+
+        [[nodiscard]] bool operator==(const InputHandle&) const noexcept = default;
+    };
+}  // namespace floah
@@ -0,0 +1,203 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_bounds.h"
+#include "floah-put/input_handle.h"
+
+namespace floah
+{
+    class InputTree;
+
+    /**
+     * \brief Tree of input elements (see InputTree), flattened into a list of hit-test steps.
+     *
+     * The tree is walked top-down, with descendants emitted before the element itself. Elements that clip their
+     * children (see InputElement::getInputClipChildren) emit a step that skips their entire subtree when the point is
+     * outside of their bounds. Ancestors that were not added to the context are part of the tree, but are never
+     * returned.
+     *
+     * Steps refer to elements by handle index, so that they do not depend on the layer order. Queries map them to
+     * positions in the sorted list and return them in that order. Bounds can be updated and elements removed in place,
+     * while other changes to the tree require a rebuild.
+     */
+    class InputHierarchy
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty hierarchy.
+         * \param resource Resource to allocate steps from.
+         */
+        explicit InputHierarchy(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        InputHierarchy(const InputHierarchy&) = delete;
+
+        InputHierarchy(InputHierarchy&&) noexcept = delete;
+
+        ~InputHierarchy() noexcept;
+
+        InputHierarchy& operator=(const InputHierarchy&) = delete;
+
+        InputHierarchy& operator=(InputHierarchy&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Hierarchy.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Rebuild the hierarchy.
+         * \param tree Element tree.
+         * \param positions Position of each element in the sorted list by handle index.
+         * \param offsets Offsets of all elements in the sorted list.
+         */
+        void build(const InputTree& tree, std::span<const uint32_t> positions, std::span<const math::int2> offsets);
+
+        /**
+         * \brief Recalculate the bounds of the steps of a single node, after its bounds or offset changed.
+         * \param tree Element tree the hierarchy was built from.
+         * \param node Node index.
+         * \param offset Offset of element.
+         * \return False if the node now needs a clipping step where it had none or vice versa, in which case the
+         * hierarchy must be rebuilt.
+         */
+        [[nodiscard]] bool update(const InputTree& tree, uint32_t node, math::int2 offset);
+
+        /**
+         * \brief Remove an element, so that it is no longer returned. Clipping steps of its node are kept.
+         * \param handle Handle of element.
+         */
+        void remove(InputHandle handle) noexcept;
+
+        /**
+         * \brief Clear the hierarchy.
+         */
+        void clear() noexcept;
+
+        /**
+         * \brief Get the indices of all elements that are not rejected by their own bounds or the bounds of a clipping
+         * ancestor.
+         * \param point Point in global space.
+         * \param positions Position of each element in the sorted list by handle index.
+         * \param candidates List that is cleared and filled with the positions of the elements, in ascending order.
+         */
+        void query(math::int2                  point,
+                   std::span<const uint32_t>   positions,
+                   std::pmr::vector<uint32_t>& candidates) const;
+
+        /**
+         * \brief Get the indices of all elements whose bounds overlap a region and that are not clipped away entirely
+         * by an ancestor, and of all unclipped elements without bounds.
+         * \param region Region in global space.
+         * \param positions Position of each element in the sorted list by handle index.
+         * \param candidates List that is cleared and filled with the positions of the elements, in ascending order.
+         * \param candidateBounds List that is cleared and filled with the global bounds of each candidate, clipped by
+         * the bounds of all clipping ancestors. Unclipped elements without bounds have bounds covering all points.
+         */
+        void query(const InputBounds&             region,
+                   std::span<const uint32_t>      positions,
+                   std::pmr::vector<uint32_t>&    candidates,
+                   std::pmr::vector<InputBounds>& candidateBounds);
+
+    private:
+        struct Step
+        {
+            enum class Type
+            {
+                /**
+                 * \brief Test bounds of a clipping element. Jump to skip if point is outside.
+                 */
+                Clip,
+
+                /**
+                 * \brief Return element as candidate if point is inside bounds.
+                 */
+                Element
+            };
+
+            Type type = Type::Element;
+
+            bool bounded = false;
+
+            /**
+             * \brief Handle index of element, or node index of clipping element.
+             */
+            uint32_t index = 0;
+
+            uint32_t skip = 0;
+
+            InputBounds bounds{};
+        };
+
+        /**
+         * \brief Node on the stack of build.
+         */
+        struct Frame
+        {
+            uint32_t node = 0;
+
+            /**
+             * \brief Next child to visit, or none.
+             */
+            uint32_t next = 0;
+
+            uint32_t clipStep = 0;
+        };
+
+        /**
+         * \brief Clipping element entered by a region query, and the end of its subtree.
+         */
+        struct Clip
+        {
+            size_t end = 0;
+
+            InputBounds bounds{};
+        };
+
+        /**
+         * \brief Element found by a region query, with its clipped bounds.
+         */
+        struct Candidate
+        {
+            uint32_t index = 0;
+
+            InputBounds bounds{};
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::pmr::vector<Step> steps;
+
+        /**
+         * \brief Element step by handle index, and clipping step by node index, or none.
+         */
+        std::pmr::vector<uint32_t> elementSteps;
+
+        std::pmr::vector<uint32_t> clipSteps;
+
+        /**
+         * \brief Scratch space of build and region queries.
+         */
+        std::pmr::vector<Frame> stack;
+
+        std::pmr::vector<Clip> clips;
+
+        std::pmr::vector<Candidate> found;
+    };
+}  // namespace floah
@@ -0,0 +1,294 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_handle.h"
+
+namespace floah
+{
+    class InputElement;
+    class InputElementRegistry;
+    class InputTree;
+
+    /**
+     * \brief Keeps a list of input elements sorted by layer descending, using precomputed sort keys.
+     *
+     * The sort key of an element is the path of input layers from its root ancestor down to the element itself,
+     * flattened into a contiguous pool. Comparing two keys lexicographically (with descendants placed on top of their
+     * ancestors) gives an order that is consistent with InputElement::compare, without walking parent chains through
+     * virtual calls. It refines the ties of compare: when the paths of two elements split at ancestors with equal
+     * layers (e.g. children of equal-layer siblings or of roots with equal layers), compare treats them as equal, while
+     * their keys order them by the remaining layers of their paths, with the deeper element on top if one key is a
+     * prefix of the other. Elements with equal keys keep the order in which they were inserted.
+     *
+     * Elements are only re-sorted when the element set or a key changed. Changed and removed elements are taken out of
+     * the sorted list, and changed and new elements are sorted among themselves and merged back in. Only the range of
+     * positions between the first and last moved element is rewritten (up to the end of the list if the number of
+     * elements changed), and a frame in which nothing changed does no work at all. Keys stay in place in their pool
+     * until they change, which leaves the old key behind until the pool is compacted.
+     */
+    class InputLayerOrder
+    {
+    public:
+        /**
+         * \brief Range of positions in the sorted list.
+         */
+        struct Range
+        {
+            uint32_t begin = 0;
+
+            uint32_t end = 0;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty order.
+         * \param resource Resource to allocate entries and sort keys from.
+         */
+        explicit InputLayerOrder(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        InputLayerOrder(const InputLayerOrder&) = delete;
+
+        InputLayerOrder(InputLayerOrder&&) noexcept = delete;
+
+        ~InputLayerOrder() noexcept;
+
+        InputLayerOrder& operator=(const InputLayerOrder&) = delete;
+
+        InputLayerOrder& operator=(InputLayerOrder&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get all elements, sorted by layer descending. Elements added or removed since the last update are not
+         * yet included or excluded.
+         * \return Elements.
+         */
+        [[nodiscard]] std::span<InputElement* const> getElements() const noexcept;
+
+        /**
+         * \brief Get the handles of all elements, in the same order as getElements.
+         * \return Handles.
+         */
+        [[nodiscard]] std::span<const InputHandle> getHandles() const noexcept;
+
+        /**
+         * \brief Get the position of an element in the sorted list.
+         * \param handle Handle of element.
+         * \return Index in getElements, or InputHandle::invalidIndex if the element is not sorted.
+         */
+        [[nodiscard]] uint32_t getPosition(InputHandle handle) const noexcept;
+
+        /**
+         * \brief Get the position of all sorted elements in the sorted list by handle index. Entries of other handle
+         * indices are undefined.
+         * \return Positions.
+         */
+        [[nodiscard]] std::span<const uint32_t> getPositions() const noexcept;
+
+        /**
+         * \brief Get the positions whose element changed in the last update that changed the order. All positions
+         * outside of the range hold the same element as before.
+         * \return Range.
+         */
+        [[nodiscard]] Range getChanged() const noexcept;
+
+        /**
+         * \brief Find an element and all its descendants among the sorted elements, using the stored paths instead of
+         * walking parent chains. Elements added or invalidated since the last update are not considered.
+         * \param root Root of subtree. Does not have to be in the list itself.
+         * \param handles List that the handles of the found elements are appended to.
+         */
+        void findSubtree(const InputElement& root, std::pmr::vector<InputHandle>& handles) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Elements.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Reserve storage for a number of elements.
+         * \param count Number of elements.
+         */
+        void reserve(size_t count);
+
+        /**
+         * \brief Add an element. It is inserted at the right position on the next update.
+         * \param handle Handle of element in registry.
+         * \param elem Element to add.
+         */
+        void add(InputHandle handle, InputElement& elem);
+
+        /**
+         * \brief Remove an element, after it was removed from the registry. It is dropped on the next update.
+         * \param handle Handle of element.
+         */
+        void remove(InputHandle handle);
+
+        /**
+         * \brief Mark the key of an element and all its descendants as changed, because the layer or parent of the
+         * element changed. Only needed for incremental updates, which find the descendants in the tree.
+         * \param elem Element. Does not have to be in the list itself.
+         */
+        void invalidate(const InputElement& elem);
+
+        ////////////////////////////////////////////////////////////////
+        // Update.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Drop removed elements, recalculate sort keys and restore the order if any element was added or had its
+         * key changed.
+         * \param registry Registry that elements were added to. Elements whose handle is no longer valid are dropped.
+         * \param tree Element tree, kept up to date as elements were added, removed and reparented. Used to find the
+         * descendants of invalidated elements. Not used for full updates.
+         * \param full If true, the keys of all elements are recalculated and all elements are checked for removal.
+         * Otherwise, only the keys of invalidated elements and their descendants are, only elements passed to remove
+         * are dropped, and if nothing was added, removed or invalidated, the update does nothing.
+         * \return True if the order changed.
+         */
+        bool update(const InputElementRegistry& registry, const InputTree& tree, bool full);
+
+    private:
+        struct Entry
+        {
+            InputHandle handle;
+
+            InputElement* element = nullptr;
+
+            /**
+             * \brief Offset of the key in the key pool.
+             */
+            uint32_t keyOffset = 0;
+
+            /**
+             * \brief Number of layers in the key.
+             */
+            uint32_t keySize = 0;
+        };
+
+        /**
+         * \brief Append the key and path of an element to the pools.
+         * \param elem Element.
+         * \param entry Entry to store key offset and size in.
+         */
+        void calculateKey(const InputElement& elem, Entry& entry);
+
+        /**
+         * \brief Gather the positions of all entries whose key has to be recalculated or that were removed.
+         * \param tree Element tree.
+         * \param full If true, all positions are gathered.
+         */
+        void gatherAffected(const InputTree& tree, bool full);
+
+        /**
+         * \brief Copy the keys and paths of all sorted entries into new pools, dropping those that were left behind.
+         */
+        void compactKeys();
+
+        /**
+         * \brief Copy elements and handles from a range of the sorted entries, and update their positions.
+         * \param range Range of entries.
+         */
+        void updateMirrors(Range range);
+
+        /**
+         * \brief Returns whether lhs should be placed before rhs.
+         * \param lhs Left entry.
+         * \param rhs Right entry.
+         * \return Boolean.
+         */
+        [[nodiscard]] bool compare(const Entry& lhs, const Entry& rhs) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Sorted entries.
+         */
+        std::pmr::vector<Entry> entries;
+
+        /**
+         * \brief Entries added since the last update.
+         */
+        std::pmr::vector<Entry> pending;
+
+        /**
+         * \brief Sorted elements, mirroring entries.
+         */
+        std::pmr::vector<InputElement*> elements;
+
+        /**
+         * \brief Sorted handles, mirroring entries.
+         */
+        std::pmr::vector<InputHandle> handles;
+
+        /**
+         * \brief Position of each sorted element by handle index.
+         */
+        std::pmr::vector<uint32_t> positions;
+
+        /**
+         * \brief Elements whose key changed since the last update.
+         */
+        std::pmr::vector<const InputElement*> invalidated;
+
+        /**
+         * \brief Sorted elements removed since the last update.
+         */
+        std::pmr::vector<InputHandle> removed;
+
+        /**
+         * \brief Flattened keys of all entries. Keys that changed are appended, and the old ones left behind.
+         */
+        std::pmr::vector<int32_t> keyPool;
+
+        /**
+         * \brief Flattened paths of all entries, i.e. the elements whose layers make up the key.
+         */
+        std::pmr::vector<const InputElement*> pathPool;
+
+        /**
+         * \brief Number of values in the pools that no entry refers to.
+         */
+        size_t garbage = 0;
+
+        /**
+         * \brief Pools that keys and paths are compacted into before being swapped with keyPool and pathPool.
+         */
+        std::pmr::vector<int32_t> scratchPool;
+
+        std::pmr::vector<const InputElement*> scratchPathPool;
+
+        /**
+         * \brief Positions of affected entries, sorted indices of pending entries and the merged entries, used during
+         * an update.
+         */
+        std::pmr::vector<uint32_t> affected;
+
+        std::pmr::vector<uint32_t> order;
+
+        std::pmr::vector<Entry> merged;
+
+        /**
+         * \brief Positions changed by the last update.
+         */
+        Range changed;
+    };
+}  // namespace floah
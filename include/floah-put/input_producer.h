@@ -0,0 +1,169 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_context.h"
+#include "floah-put/input_signal.h"
+#include "floah-put/input_spsc_queue.h"
+
+namespace floah
+{
+    /**
+     * \brief Thread-safe front end for submitting input events to an InputContext from another thread.
+     *
+     * A producer is created through InputContext::addProducer. All setters may be called from a single producer thread
+     * (e.g. a dedicated windowing/input thread) while the thread that owns the context calls postPoll, which drains
+     * the events. Neither side takes a lock, except to wake up the owning thread while it is blocked in
+     * InputContext::waitForInput. Use one producer per submitting thread.
+     */
+    class InputProducer
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct a producer.
+         * \param capacity Minimum number of events the producer can hold.
+         * \param s Signal notified after every submitted event, or nullptr.
+         */
+        explicit InputProducer(size_t capacity, InputSignal* s = nullptr);
+
+        InputProducer(const InputProducer&) = delete;
+
+        InputProducer(InputProducer&&) noexcept = delete;
+
+        ~InputProducer() noexcept;
+
+        InputProducer& operator=(const InputProducer&) = delete;
+
+        InputProducer& operator=(InputProducer&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of events that were dropped because the queue was full. Can be called from any thread.
+         * \return Number of dropped events since construction.
+         */
+        [[nodiscard]] size_t getDroppedEventCount() const noexcept;
+
+        /**
+         * \brief Get the number of events the producer can hold between polls.
+         * \return Capacity.
+         */
+        [[nodiscard]] size_t getCapacity() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the current time. Events submitted after this call are stamped with this time.
+         * \param t Time.
+         */
+        void setTime(int64_t t) noexcept;
+
+        /**
+         * \brief Set the source timestamp of the events submitted after this call. See InputContext::setTimestamp.
+         * \param ns Timestamp in nanoseconds of std::chrono::steady_clock. 0 (the default) stamps every event with the
+         * time at which it is pushed.
+         */
+        void setTimestamp(int64_t ns) noexcept;
+
+        void setEnter(bool e) noexcept;
+
+        void setEnter(uint32_t pointer, bool e) noexcept;
+
+        void setCursor(math::int2 c) noexcept;
+
+        void setCursor(uint32_t pointer, math::int2 c) noexcept;
+
+        /**
+         * \brief Queue a cursor event with sub-pixel precision. See InputContext::setPreciseCursor.
+         * \param c Cursor position in precise units (see InputContext::subpixelScale).
+         */
+        void setPreciseCursor(math::int2 c) noexcept;
+
+        void setPreciseCursor(uint32_t pointer, math::int2 c) noexcept;
+
+        void setMouseButton(InputContext::MouseButton    button,
+                            InputContext::MouseAction    action,
+                            InputContext::MouseModifiers mods) noexcept;
+
+        void setMouseButton(uint32_t                     pointer,
+                            InputContext::MouseButton    button,
+                            InputContext::MouseAction    action,
+                            InputContext::MouseModifiers mods) noexcept;
+
+        void setScroll(math::int2 s) noexcept;
+
+        void setScroll(uint32_t pointer, math::int2 s) noexcept;
+
+        /**
+         * \brief Queue a scroll event with fractional steps. See InputContext::setPreciseScroll.
+         * \param s Scroll distance in precise units (see InputContext::subpixelScale).
+         */
+        void setPreciseScroll(math::int2 s) noexcept;
+
+        void setPreciseScroll(uint32_t pointer, math::int2 s) noexcept;
+
+        void setKey(int32_t                      key,
+                    int32_t                      scancode,
+                    InputContext::KeyAction      action,
+                    InputContext::MouseModifiers mods) noexcept;
+
+        /**
+         * \brief Queue text input. Takes one slot of the queue per codepoint. Consecutive text is merged by the
+         * context.
+         * \param codepoint Unicode codepoint.
+         */
+        void setText(char32_t codepoint) noexcept;
+
+        void setText(std::u32string_view codepoints) noexcept;
+
+    private:
+        friend class InputContext;
+
+        void push(const InputContext::InputEvent& event) noexcept;
+
+        /**
+         * \brief Pop an event. Only called by the context.
+         * \param event Popped event.
+         * \return True if an event was popped.
+         */
+        bool pop(InputContext::InputEvent& event) noexcept;
+
+        /**
+         * \brief Returns whether there are no events to pop. Only called by the context.
+         * \return True if empty.
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        int64_t time = 0;
+
+        int64_t timestamp = 0;
+
+        InputSpscQueue<InputContext::InputEvent> queue;
+
+        InputSignal* signal = nullptr;
+
+        std::atomic<size_t> droppedEvents = 0;
+    };
+}  // namespace floah
@@ -0,0 +1,134 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_handle.h"
+
+namespace floah
+{
+    class InputTree;
+
+    /**
+     * \brief Ancestors of input elements that receive the events of their descendants (see
+     * InputElement::getInputPropagation), stored as a contiguous array per element by handle index.
+     *
+     * Paths are calculated once when built, so that propagating an event walks a short array instead of calling
+     * InputElement::getInputParent for every ancestor. Children of the same parent share a path, and so do the
+     * children of elements that do not listen and the element itself.
+     */
+    class InputPropagationPaths
+    {
+    public:
+        struct Entry
+        {
+            InputHandle handle;
+
+            /**
+             * \brief If true, the ancestor receives events before the element.
+             */
+            bool capture = false;
+
+            /**
+             * \brief If true, the ancestor receives events after the element.
+             */
+            bool bubble = false;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty set of paths.
+         * \param resource Resource to allocate paths from.
+         */
+        explicit InputPropagationPaths(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        InputPropagationPaths(const InputPropagationPaths&) = delete;
+
+        InputPropagationPaths(InputPropagationPaths&&) noexcept = delete;
+
+        ~InputPropagationPaths() noexcept;
+
+        InputPropagationPaths& operator=(const InputPropagationPaths&) = delete;
+
+        InputPropagationPaths& operator=(InputPropagationPaths&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the listening ancestors of an element.
+         * \param handle Handle of element.
+         * \return Ancestors, from the parent up to the root. Empty if the element was not in the tree the paths were
+         * last built from.
+         */
+        [[nodiscard]] std::span<const Entry> get(InputHandle handle) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Paths.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Recalculate the paths of all elements in a tree.
+         * \param tree Element tree.
+         * \param slotCount Number of handle slots in the element registry.
+         */
+        void build(const InputTree& tree, size_t slotCount);
+
+        /**
+         * \brief Clear the paths.
+         */
+        void clear() noexcept;
+
+    private:
+        /**
+         * \brief Range of entries.
+         */
+        struct Path
+        {
+            uint32_t offset = 0;
+
+            uint32_t count = 0;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Entries of all paths, concatenated.
+         */
+        std::pmr::vector<Entry> entries;
+
+        /**
+         * \brief Path by handle index.
+         */
+        std::pmr::vector<Path> paths;
+
+        /**
+         * \brief Handle each path was built for, by handle index.
+         */
+        std::pmr::vector<InputHandle> handles;
+
+        /**
+         * \brief Path of each tree node and node stack, used while building.
+         */
+        std::pmr::vector<Path> nodePaths;
+
+        std::pmr::vector<uint32_t> stack;
+    };
+}  // namespace floah
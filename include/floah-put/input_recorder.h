@@ -0,0 +1,200 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_context.h"
+
+namespace floah
+{
+    /**
+     * \brief Records all input fed to an InputContext into a compact binary stream, which can be replayed with
+     * InputReplay. Attach a recorder with InputContext::setRecorder.
+     *
+     * The stream starts with a header (magic and version, both 32-bit little-endian), followed by records. Each record
+     * is a single byte holding its type, followed by a payload. Integers in payloads are zigzag-encoded LEB128
+     * varints. Times and cursor positions are stored as the difference with the previous value (cursor positions per
+     * pointer), so that a typical record takes only a few bytes. Events belong to the mouse pointer until a pointer
+     * record is written. Key and text events do not belong to a pointer.
+     *
+     * Cursor positions and scroll distances are stored in precise units (see InputContext::subpixelScale). Version 1
+     * streams stored whole pixels and steps, and are scaled when replayed.
+     *
+     * The payload of every event record (enter, cursor, button, scroll, key and text) starts with the difference
+     * between the time of the event and the last recorded time, which is 0 for events submitted through the setters
+     * of the context, but not for events of producers. Streams before version 3 did not store it and replay all events
+     * at the context time.
+     */
+    class InputRecorder
+    {
+    public:
+        static constexpr uint32_t magic = 0x52495046;  // "FPIR"
+
+        static constexpr uint32_t version = 3;
+
+        enum class Record : uint8_t
+        {
+            /**
+             * \brief Call to InputContext::prePoll. No payload.
+             */
+            PrePoll = 0,
+
+            /**
+             * \brief Call to InputContext::postPoll. No payload. Events submitted by producers during the poll are
+             * recorded before this record.
+             */
+            PostPoll = 1,
+
+            /**
+             * \brief Time change. Payload: difference with previous time.
+             */
+            Time = 2,
+
+            /**
+             * \brief Call to InputContext::setFocus. Payload: 1 byte.
+             */
+            Focus = 3,
+
+            /**
+             * \brief Enter event. Payload: 1 byte.
+             */
+            Enter = 4,
+
+            /**
+             * \brief Cursor event. Payload: difference with previous cursor position, x then y.
+             */
+            Cursor = 5,
+
+            /**
+             * \brief Button event. Payload: 1 byte with the button in bits 0-1 and action in bit 2, 1 byte modifiers.
+             */
+            Button = 6,
+
+            /**
+             * \brief Scroll event. Payload: scroll distance, x then y.
+             */
+            Scroll = 7,
+
+            /**
+             * \brief Call to InputContext::clearMouseButton. No payload.
+             */
+            ClearButtons = 8,
+
+            /**
+             * \brief Pointer change. All following events belong to this pointer. Payload: pointer ID.
+             */
+            Pointer = 9,
+
+            /**
+             * \brief Key event. Payload: key, scancode, then 1 byte action and 1 byte modifiers.
+             */
+            Key = 10,
+
+            /**
+             * \brief Text event. Payload: codepoint.
+             */
+            Text = 11
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InputRecorder();
+
+        InputRecorder(const InputRecorder&) = delete;
+
+        InputRecorder(InputRecorder&&) noexcept = delete;
+
+        ~InputRecorder() noexcept;
+
+        InputRecorder& operator=(const InputRecorder&) = delete;
+
+        InputRecorder& operator=(InputRecorder&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the recorded stream, including the header.
+         * \return Stream.
+         */
+        [[nodiscard]] std::span<const std::byte> getData() const noexcept;
+
+        /**
+         * \brief Get the number of recorded calls to postPoll.
+         * \return Number of frames.
+         */
+        [[nodiscard]] size_t getFrameCount() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Recording.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Discard everything that was recorded.
+         */
+        void clear();
+
+        /**
+         * \brief Write the recorded stream to a file.
+         * \param path File path.
+         * \return True on success.
+         */
+        [[nodiscard]] bool save(const std::filesystem::path& path) const;
+
+        void recordPrePoll();
+
+        void recordPostPoll();
+
+        void recordTime(int64_t t);
+
+        void recordFocus(bool f);
+
+        /**
+         * \brief Record an event, including its time. The last recorded time is not changed, because events of
+         * producers carry their own time.
+         * \param event Event.
+         */
+        void recordEvent(const InputContext::InputEvent& event);
+
+        void recordClearButtons();
+
+    private:
+        void writeRecord(Record record);
+
+        void writeByte(uint8_t value);
+
+        void writeVarint(int64_t value);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::vector<std::byte> data;
+
+        size_t frameCount = 0;
+
+        int64_t time = 0;
+
+        uint32_t pointer = InputContext::mousePointer;
+
+        /**
+         * \brief Last recorded position of each pointer, by pointer ID. Pointers without an entry are at (0, 0).
+         */
+        std::vector<std::pair<uint32_t, math::int2>> cursors;
+    };
+}  // namespace floah
@@ -0,0 +1,125 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_context.h"
+
+namespace floah
+{
+    /**
+     * \brief Replays a stream recorded by InputRecorder into an InputContext as fast as possible. Streams are read
+     * from a memory-mapped file or from memory, without copying.
+     */
+    class InputReplay
+    {
+    public:
+        struct Result
+        {
+            /**
+             * \brief Number of replayed calls to postPoll.
+             */
+            size_t frames = 0;
+
+            /**
+             * \brief Number of replayed events.
+             */
+            size_t events = 0;
+
+            /**
+             * \brief Nanoseconds spent in the entire replay.
+             */
+            uint64_t totalTime = 0;
+
+            /**
+             * \brief Nanoseconds spent in each call to postPoll.
+             */
+            std::vector<uint64_t> frameTimes;
+
+            /**
+             * \brief If false, the stream ended with an incomplete or unknown record. Everything before it was
+             * replayed.
+             */
+            bool complete = true;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InputReplay();
+
+        InputReplay(const InputReplay&) = delete;
+
+        InputReplay(InputReplay&&) noexcept = delete;
+
+        ~InputReplay() noexcept;
+
+        InputReplay& operator=(const InputReplay&) = delete;
+
+        InputReplay& operator=(InputReplay&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the opened stream, including the header.
+         * \return Stream, or an empty span if nothing is opened.
+         */
+        [[nodiscard]] std::span<const std::byte> getData() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Replay.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Memory-map a recorded file. Closes the previously opened stream.
+         * \param path File path.
+         * \return True if the file was mapped and has a valid header.
+         */
+        [[nodiscard]] bool open(const std::filesystem::path& path);
+
+        /**
+         * \brief Use a recorded stream in memory. The memory is not copied and must outlive the replay (or the next
+         * call to open or close). Closes the previously opened stream.
+         * \param stream Stream.
+         * \return True if the stream has a valid header.
+         */
+        [[nodiscard]] bool open(std::span<const std::byte> stream);
+
+        void close() noexcept;
+
+        /**
+         * \brief Replay the opened stream into a context. Elements must be added to the context beforehand.
+         * \param context Context.
+         * \return Result.
+         */
+        [[nodiscard]] Result run(InputContext& context) const;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::span<const std::byte> data;
+
+        /**
+         * \brief Start and size of the mapped file, if the stream was memory-mapped.
+         */
+        void* mapping = nullptr;
+
+        size_t mappingSize = 0;
+    };
+}  // namespace floah
@@ -0,0 +1,161 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace floah
+{
+    /**
+     * \brief Fixed-capacity FIFO queue. Storage is allocated once on construction or when the capacity is changed, so
+     * pushing and popping never allocate.
+     * \tparam T Value type.
+     */
+    template<typename T>
+    class InputRingBuffer
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InputRingBuffer() = default;
+
+        /**
+         * \brief Construct a buffer with a capacity.
+         * \param capacity Capacity.
+         * \param resource Resource to allocate the storage from.
+         */
+        explicit InputRingBuffer(const size_t               capacity,
+                                 std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+            values(capacity, resource)
+        {
+        }
+
+        InputRingBuffer(const InputRingBuffer&) = delete;
+
+        InputRingBuffer(InputRingBuffer&&) noexcept = default;
+
+        ~InputRingBuffer() noexcept = default;
+
+        InputRingBuffer& operator=(const InputRingBuffer&) = delete;
+
+        InputRingBuffer& operator=(InputRingBuffer&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] size_t capacity() const noexcept { return values.size(); }
+
+        [[nodiscard]] size_t size() const noexcept { return count; }
+
+        [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+        [[nodiscard]] bool full() const noexcept { return count == values.size(); }
+
+        /**
+         * \brief Get the value at a position in the queue. 0 is the oldest value.
+         * \param index Index. Must be smaller than size.
+         * \return Value.
+         */
+        [[nodiscard]] T& operator[](const size_t index) noexcept { return values[(head + index) % values.size()]; }
+
+        [[nodiscard]] const T& operator[](const size_t index) const noexcept
+        {
+            return values[(head + index) % values.size()];
+        }
+
+        /**
+         * \brief Get the most recently pushed value. Queue must not be empty.
+         * \return Value.
+         */
+        [[nodiscard]] T& back() noexcept { return (*this)[count - 1]; }
+
+        ////////////////////////////////////////////////////////////////
+        // Modifiers.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Change the capacity. Clears the queue.
+         * \param capacity Capacity.
+         */
+        void reset(const size_t capacity)
+        {
+            values.assign(capacity, T{});
+            clear();
+        }
+
+        /**
+         * \brief Increase the capacity to at least the given value. Preserves the queue.
+         * \param capacity Minimum capacity.
+         */
+        void reserve(const size_t capacity)
+        {
+            if (capacity <= values.size()) return;
+            std::pmr::vector<T> v(capacity, values.get_allocator());
+            for (size_t i = 0; i < count; i++) v[i] = (*this)[i];
+            values = std::move(v);
+            head   = 0;
+        }
+
+        /**
+         * \brief Push a value to the back of the queue.
+         * \param value Value.
+         * \return True if value was pushed, false if the queue was full.
+         */
+        bool push(const T& value) noexcept
+        {
+            if (full()) return false;
+            values[(head + count) % values.size()] = value;
+            count++;
+            return true;
+        }
+
+        /**
+         * \brief Pop a value from the front of the queue.
+         * \param value Popped value.
+         * \return True if a value was popped, false if the queue was empty.
+         */
+        bool pop(T& value) noexcept
+        {
+            if (empty()) return false;
+            value = values[head];
+            head  = (head + 1) % values.size();
+            count--;
+            return true;
+        }
+
+        /**
+         * \brief Remove all values for which the predicate returns true, preserving the order of the other values.
+         * \tparam F Predicate type.
+         * \param f Predicate.
+         */
+        template<typename F>
+        void removeIf(F&& f)
+        {
+            size_t kept = 0;
+            for (size_t i = 0; i < count; i++)
+                if (!f((*this)[i])) (*this)[kept++] = (*this)[i];
+            count = kept;
+        }
+
+        void clear() noexcept
+        {
+            head  = 0;
+            count = 0;
+        }
+
+    private:
+        std::pmr::vector<T> values;
+
+        size_t head = 0;
+
+        size_t count = 0;
+    };
+}  // namespace floah
@@ -0,0 +1,137 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <span>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_bounds.h"
+
+namespace floah
+{
+    /**
+     * \brief Built-in hit shape of an input element (see InputElement::getInputShape). Elements with a built-in shape
+     * are hit-tested by the input context without calling InputElement::intersect.
+     *
+     * A point is inside of a shape if the center of its pixel is. Polygon vertices and mask data are not copied and
+     * must remain valid for as long as the shape is in use, i.e. until the element is removed or its bounds are
+     * invalidated.
+     */
+    struct InputShape
+    {
+        enum class Type : uint8_t
+        {
+            /**
+             * \brief Axis-aligned rectangle covering the bounds.
+             */
+            Rect = 0,
+
+            /**
+             * \brief Axis-aligned rectangle covering the bounds with circular corners.
+             */
+            RoundedRect = 1,
+
+            /**
+             * \brief Axis-aligned ellipse inscribed in the bounds.
+             */
+            Ellipse = 2,
+
+            /**
+             * \brief Convex polygon. Vertices can be in either winding order.
+             */
+            Polygon = 3,
+
+            /**
+             * \brief Bitmap of alpha values covering the bounds. Pixels with an alpha at or above the threshold are
+             * inside.
+             */
+            Mask = 4
+        };
+
+        Type type = Type::Rect;
+
+        /**
+         * \brief Bounds of the shape. For polygons, the bounds of the vertices.
+         */
+        InputBounds bounds;
+
+        /**
+         * \brief Corner radius of a rounded rectangle. Clamped to half the width and height.
+         */
+        int32_t radius = 0;
+
+        /**
+         * \brief Minimum alpha of a mask.
+         */
+        uint8_t threshold = 0;
+
+        /**
+         * \brief Vertices of a polygon.
+         */
+        std::span<const math::int2> vertices{};
+
+        /**
+         * \brief Alpha values of a mask, row by row. Must contain at least (height - 1) * stride + width values. Masks
+         * with less data contain no point.
+         */
+        std::span<const uint8_t> alpha{};
+
+        /**
+         * \brief Distance between the rows of a mask.
+         */
+        size_t stride = 0;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] static InputShape rect(const InputBounds& bounds) noexcept;
+
+        [[nodiscard]] static InputShape roundedRect(const InputBounds& bounds, int32_t radius) noexcept;
+
+        [[nodiscard]] static InputShape ellipse(const InputBounds& bounds) noexcept;
+
+        /**
+         * \brief Create a convex polygon. Polygons with fewer than 3 vertices contain no point.
+         * \param vertices Vertices.
+         * \return Shape.
+         */
+        [[nodiscard]] static InputShape polygon(std::span<const math::int2> vertices) noexcept;
+
+        /**
+         * \brief Create an alpha mask.
+         * \param bounds Bounds. The mask has one alpha value per pixel of the bounds.
+         * \param alpha Alpha values.
+         * \param threshold Minimum alpha.
+         * \param stride Distance between rows. 0 to use the width of the bounds.
+         * \return Shape.
+         */
+        [[nodiscard]] static InputShape mask(const InputBounds&       bounds,
+                                             std::span<const uint8_t> alpha,
+                                             uint8_t                  threshold,
+                                             size_t                   stride = 0) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Intersection.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Returns whether point is inside of shape.
+         * \param point Point.
+         * \return True if point is inside.
+         */
+        [[nodiscard]] bool contains(math::int2 point) const noexcept;
+
+        /**
+         * \brief Returns whether the mask has enough alpha values to cover its bounds.
+         * \return True if valid.
+         */
+        [[nodiscard]] bool validMask() const noexcept;
+    };
+}  // namespace floah
@@ -0,0 +1,181 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_shape.h"
+
+namespace floah
+{
+    class InputElement;
+
+    /**
+     * \brief Structure-of-arrays copy of the built-in shapes (see InputElement::getInputShape) of a list of input
+     * elements in global space, for testing a point against a block of shapes at once.
+     *
+     * Elements are referred to by their index in the list the buffer was built from. Rectangles, rounded rectangles and
+     * ellipses are tested exactly by the block test. Polygons and masks only by their bounds, and elements without a
+     * shape by their bounds (see InputElement::getInputBounds), if any. Arrays are padded to a whole number of blocks
+     * with inverted bounds, which contain no point.
+     */
+    class InputShapeBuffer
+    {
+    public:
+        /**
+         * \brief Number of shapes tested by a single call to test.
+         */
+        static constexpr size_t blockSize = 8;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty buffer.
+         * \param resource Resource to allocate the shapes from.
+         */
+        explicit InputShapeBuffer(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        InputShapeBuffer(const InputShapeBuffer&) = delete;
+
+        InputShapeBuffer(InputShapeBuffer&&) noexcept = delete;
+
+        ~InputShapeBuffer() noexcept;
+
+        InputShapeBuffer& operator=(const InputShapeBuffer&) = delete;
+
+        InputShapeBuffer& operator=(InputShapeBuffer&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of blocks.
+         * \return Number of blocks.
+         */
+        [[nodiscard]] size_t getBlockCount() const noexcept;
+
+        /**
+         * \brief Returns whether an element has a built-in shape.
+         * \param index Element index.
+         * \return True if element has a shape, false if it must be tested with InputElement::intersect.
+         */
+        [[nodiscard]] bool hasShape(size_t index) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Buffer.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Rebuild the buffer.
+         * \param elements Elements.
+         * \param offsets Offsets of elements.
+         */
+        void build(std::span<InputElement* const> elements, std::span<const math::int2> offsets);
+
+        /**
+         * \brief Change the number of elements. Elements past the new count become padding, new elements must be
+         * updated before they are tested.
+         * \param count Number of elements.
+         */
+        void resize(size_t count);
+
+        /**
+         * \brief Update the shape of a single element.
+         * \param index Index of element in the list the buffer was built from.
+         * \param elem Element.
+         * \param offset Offset of element.
+         */
+        void update(size_t index, const InputElement& elem, math::int2 offset);
+
+        /**
+         * \brief Clear the buffer.
+         */
+        void clear() noexcept;
+
+        /**
+         * \brief Test a point against the shape of a single element.
+         * \param index Index of element with a shape.
+         * \param point Point in global space.
+         * \return True if point is inside.
+         */
+        [[nodiscard]] bool intersect(size_t index, math::int2 point) const noexcept;
+
+        /**
+         * \brief Test a point against all shapes in a block.
+         * \param block Block index.
+         * \param point Point in global space.
+         * \return Bit mask with bit i set if element block * blockSize + i might contain the point. Exact for
+         * rectangles, rounded rectangles and ellipses.
+         */
+        [[nodiscard]] uint32_t test(size_t block, math::int2 point) const noexcept;
+
+    private:
+        /**
+         * \brief Shape of an element, with its offset.
+         */
+        struct Entry
+        {
+            InputShape shape;
+
+            math::int2 offset;
+        };
+
+        /**
+         * \brief Drop the entries of elements that no longer have a shape.
+         */
+        void compact();
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::pmr::vector<int32_t> lowerX;
+
+        std::pmr::vector<int32_t> lowerY;
+
+        std::pmr::vector<int32_t> upperX;
+
+        std::pmr::vector<int32_t> upperY;
+
+        /**
+         * \brief Sum of the lower and upper corner, i.e. twice the center. Stored as double, which holds the sum and
+         * its distance to any point exactly, where int32_t would overflow.
+         */
+        std::pmr::vector<double> centerX;
+
+        std::pmr::vector<double> centerY;
+
+        /**
+         * \brief Curves are tested as max(|2 * point + 1 - center| * scale - extent, 0), squared and summed over both
+         * axes, against radius2. Zero for shapes that are not curved, which always pass.
+         */
+        std::pmr::vector<float> scaleX;
+
+        std::pmr::vector<float> scaleY;
+
+        std::pmr::vector<float> extentX;
+
+        std::pmr::vector<float> extentY;
+
+        std::pmr::vector<float> radius2;
+
+        /**
+         * \brief Index into entries for every element, or none.
+         */
+        std::pmr::vector<uint32_t> shapes;
+
+        std::pmr::vector<Entry> entries;
+    };
+}  // namespace floah
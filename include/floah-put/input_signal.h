@@ -0,0 +1,83 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace floah
+{
+    /**
+     * \brief Lets a thread sleep until another thread signals it. Signalling only takes a lock while a thread is
+     * actually waiting, so that producers that signal after every event do not contend with each other or the waiting
+     * thread while it is busy.
+     */
+    class InputSignal
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InputSignal();
+
+        InputSignal(const InputSignal&) = delete;
+
+        InputSignal(InputSignal&&) noexcept = delete;
+
+        ~InputSignal() noexcept;
+
+        InputSignal& operator=(const InputSignal&) = delete;
+
+        InputSignal& operator=(InputSignal&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of times the signal was notified. Read this before checking for work, and pass it to
+         * wait afterwards, so that notifications in between are not missed.
+         * \return Count.
+         */
+        [[nodiscard]] uint64_t get() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Signalling.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Wake up the waiting thread, if any. Can be called from any thread.
+         */
+        void notify() noexcept;
+
+        /**
+         * \brief Wait until the signal is notified.
+         * \param seen Count returned by get before checking for work.
+         * \param timeout Maximum time to wait.
+         * \return True if the signal was notified since get returned seen, false on timeout.
+         */
+        bool wait(uint64_t seen, std::chrono::nanoseconds timeout);
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::atomic<uint64_t> count = 0;
+
+        /**
+         * \brief Number of threads inside of wait.
+         */
+        std::atomic<uint32_t> waiters = 0;
+
+        std::mutex mutex;
+
+        std::condition_variable condition;
+    };
+}  // namespace floah
@@ -0,0 +1,250 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_bounds.h"
+#include "floah-put/input_handle.h"
+
+namespace floah
+{
+    class InputElement;
+
+    /**
+     * \brief Uniform grid over the global bounds of input elements, used to find hit-test candidates without testing
+     * every element.
+     *
+     * Elements are referred to by handle index, so that the grid does not depend on the layer order. Queries map them
+     * to positions in the sorted list and return them in that order. Elements without bounds are returned as
+     * candidates for every point. Elements can be added, moved and removed in place. Bounds outside of the grid are
+     * clamped to its border cells, so the grid should be rebuilt once it no longer fits (see isStale).
+     */
+    class InputSpatialIndex
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty index.
+         * \param resource Resource to allocate cells from.
+         */
+        explicit InputSpatialIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        InputSpatialIndex(const InputSpatialIndex&) = delete;
+
+        InputSpatialIndex(InputSpatialIndex&&) noexcept = delete;
+
+        ~InputSpatialIndex() noexcept;
+
+        InputSpatialIndex& operator=(const InputSpatialIndex&) = delete;
+
+        InputSpatialIndex& operator=(InputSpatialIndex&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] int32_t getCellSize() const noexcept;
+
+        /**
+         * \brief Returns whether more elements were updated since the last build than there were elements at the time.
+         * Rebuilding then fits the grid to the current bounds again, at no more cost than those updates.
+         * \return True if the index should be rebuilt.
+         */
+        [[nodiscard]] bool isStale() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the preferred size of grid cells. The actual size can be larger to limit the number of cells.
+         * Takes effect on the next build.
+         * \param size Cell size. Must be larger than 0.
+         */
+        void setCellSize(int32_t size) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Index.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Rebuild the index.
+         * \param elements Elements.
+         * \param handles Handles of elements.
+         * \param offsets Offsets of elements.
+         */
+        void build(std::span<InputElement* const> elements,
+                   std::span<const InputHandle>   handles,
+                   std::span<const math::int2>    offsets);
+
+        /**
+         * \brief Add an element, or move it to the cells covered by its current bounds.
+         * \param handle Handle of element.
+         * \param elem Element.
+         * \param offset Offset of element.
+         */
+        void update(InputHandle handle, const InputElement& elem, math::int2 offset);
+
+        /**
+         * \brief Remove an element.
+         * \param handle Handle of element.
+         */
+        void remove(InputHandle handle) noexcept;
+
+        /**
+         * \brief Clear the index.
+         */
+        void clear() noexcept;
+
+        /**
+         * \brief Get the positions of all elements whose bounds contain a point, and of all elements without bounds.
+         * \param point Point in global space.
+         * \param positions Position of each element in the sorted list by handle index.
+         * \param candidates List that is cleared and filled with the positions of the elements, in ascending order.
+         */
+        void query(math::int2                  point,
+                   std::span<const uint32_t>   positions,
+                   std::pmr::vector<uint32_t>& candidates) const;
+
+        /**
+         * \brief Get the positions of all elements whose bounds overlap a region, and of all elements without bounds.
+         * \param region Region in global space.
+         * \param positions Position of each element in the sorted list by handle index.
+         * \param candidates List that is cleared and filled with the positions of the elements, in ascending order.
+         * \param candidateBounds List that is filled with the global bounds of each candidate. Elements without bounds
+         * have bounds covering all points.
+         */
+        void query(const InputBounds&             region,
+                   std::span<const uint32_t>      positions,
+                   std::pmr::vector<uint32_t>&    candidates,
+                   std::pmr::vector<InputBounds>& candidateBounds) const;
+
+    private:
+        /**
+         * \brief Where an element is stored.
+         */
+        enum class Kind : uint8_t
+        {
+            /**
+             * \brief Not in the index, or bounds are empty, so that it can never be hit.
+             */
+            None,
+
+            Unbounded,
+
+            Cells
+        };
+
+        /**
+         * \brief Entry of the element list of a cell.
+         */
+        struct Link
+        {
+            uint32_t element = 0;
+
+            uint32_t next = 0;
+        };
+
+        /**
+         * \brief Range of cells covered by bounds, clamped to the grid. Upper bounds are inclusive.
+         */
+        struct CellRange
+        {
+            int64_t x0 = 0;
+
+            int64_t y0 = 0;
+
+            int64_t x1 = 0;
+
+            int64_t y1 = 0;
+        };
+
+        /**
+         * \brief Fit the grid to a region, sizing cells so that their number is proportional to the number of elements.
+         * \param extent Region covered by the grid.
+         * \param count Number of bounded elements.
+         */
+        void fit(const InputBounds& extent, size_t count);
+
+        /**
+         * \brief Get the cells covered by bounds.
+         * \param b Non-empty bounds in global space.
+         * \return Cell range.
+         */
+        [[nodiscard]] CellRange getCells(const InputBounds& b) const noexcept;
+
+        /**
+         * \brief Add an element to all cells covered by its bounds.
+         * \param element Handle index of element.
+         */
+        void link(uint32_t element);
+
+        /**
+         * \brief Remove an element from all cells covered by its bounds.
+         * \param element Handle index of element.
+         */
+        void unlink(uint32_t element) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        int32_t preferredCellSize = 64;
+
+        int32_t cellSize = 64;
+
+        /**
+         * \brief Lower corner of the grid.
+         */
+        math::int2 origin;
+
+        int64_t columns = 0;
+
+        int64_t rows = 0;
+
+        /**
+         * \brief Global bounds of all elements, by handle index. Only valid for elements that are in cells.
+         */
+        std::pmr::vector<InputBounds> bounds;
+
+        std::pmr::vector<Kind> kinds;
+
+        /**
+         * \brief Handle indices of elements without bounds.
+         */
+        std::pmr::vector<uint32_t> unbounded;
+
+        /**
+         * \brief Per cell, index of its first link, or none.
+         */
+        std::pmr::vector<uint32_t> cells;
+
+        /**
+         * \brief Element lists of all cells. Unused links form a free list.
+         */
+        std::pmr::vector<Link> links;
+
+        uint32_t firstFree = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * \brief Number of elements at the last build, and of updates and removals since.
+         */
+        size_t builtCount = 0;
+
+        size_t updateCount = 0;
+    };
+}  // namespace floah
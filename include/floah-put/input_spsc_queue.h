@@ -0,0 +1,128 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+namespace floah
+{
+    /**
+     * \brief Bounded wait-free single-producer single-consumer queue. One thread may push while another thread pops,
+     * without locking. Storage is allocated once on construction.
+     * \tparam T Value type.
+     */
+    template<typename T>
+    class InputSpscQueue
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct a queue.
+         * \param capacity Minimum capacity. Rounded up to a power of two.
+         */
+        explicit InputSpscQueue(const size_t capacity) :
+            values(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)), mask(values.size() - 1)
+        {
+        }
+
+        InputSpscQueue(const InputSpscQueue&) = delete;
+
+        InputSpscQueue(InputSpscQueue&&) noexcept = delete;
+
+        ~InputSpscQueue() noexcept = default;
+
+        InputSpscQueue& operator=(const InputSpscQueue&) = delete;
+
+        InputSpscQueue& operator=(InputSpscQueue&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] size_t capacity() const noexcept { return values.size(); }
+
+        /**
+         * \brief Returns whether the queue is empty. May only be called from the consumer thread.
+         * \return True if empty.
+         */
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Modifiers.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Push a value. May only be called from the producer thread.
+         * \param value Value.
+         * \return True if value was pushed, false if the queue was full.
+         */
+        bool push(const T& value) noexcept
+        {
+            const auto t = tail.load(std::memory_order_relaxed);
+            if (t - cachedHead == values.size())
+            {
+                cachedHead = head.load(std::memory_order_acquire);
+                if (t - cachedHead == values.size()) return false;
+            }
+
+            values[t & mask] = value;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * \brief Pop a value. May only be called from the consumer thread.
+         * \param value Popped value.
+         * \return True if a value was popped, false if the queue was empty.
+         */
+        bool pop(T& value) noexcept
+        {
+            const auto h = head.load(std::memory_order_relaxed);
+            if (h == cachedTail)
+            {
+                cachedTail = tail.load(std::memory_order_acquire);
+                if (h == cachedTail) return false;
+            }
+
+            value = values[h & mask];
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::vector<T> values;
+
+        size_t mask;
+
+        /**
+         * \brief Index of the next value to pop. Written by the consumer.
+         */
+        alignas(64) std::atomic<size_t> head = 0;
+
+        /**
+         * \brief Consumer's copy of tail.
+         */
+        size_t cachedTail = 0;
+
+        /**
+         * \brief Index of the next value to push. Written by the producer.
+         */
+        alignas(64) std::atomic<size_t> tail = 0;
+
+        /**
+         * \brief Producer's copy of head.
+         */
+        size_t cachedHead = 0;
+    };
+}  // namespace floah
@@ -0,0 +1,311 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace floah
+{
+    /**
+     * \brief Values measured by an InputContext during a single frame (i.e. a call to postPoll).
+     */
+    enum class InputMetric : size_t
+    {
+        /**
+         * \brief Nanoseconds spent restoring the layer order and rebuilding hit-test caches.
+         */
+        SortTime = 0,
+
+        /**
+         * \brief Nanoseconds spent in hit-testing and dispatching enter and exit events, excluding SortTime.
+         */
+        EnterTime,
+
+        /**
+         * \brief Nanoseconds spent dispatching move events.
+         */
+        MoveTime,
+
+        /**
+         * \brief Nanoseconds spent dispatching click events.
+         */
+        ClickTime,
+
+        /**
+         * \brief Nanoseconds spent dispatching scroll events.
+         */
+        ScrollTime,
+
+        /**
+         * \brief Number of calls to InputElement::intersect.
+         */
+        IntersectCalls,
+
+        /**
+         * \brief Number of elements tested against their built-in shape (see InputElement::getInputShape) instead of
+         * calling InputElement::intersect.
+         */
+        ShapeTests,
+
+        /**
+         * \brief Number of elements compared with the sorted position of the entered element.
+         */
+        CompareCalls,
+
+        /**
+         * \brief Number of events passed to element event handlers.
+         */
+        DispatchedEvents,
+
+        /**
+         * \brief Number of events dropped because a queue was full.
+         */
+        DroppedEvents,
+
+        /**
+         * \brief Number of times the element under the cursor was not resolved again, because nothing changed since
+         * the previous resolution.
+         */
+        HoverReuses,
+
+        Count
+    };
+
+    inline constexpr size_t inputMetricCount = static_cast<size_t>(InputMetric::Count);
+
+    /**
+     * \brief Types of events whose latency, i.e. the time between their source timestamp (see
+     * InputContext::setTimestamp) and the moment they are dispatched to elements, is measured by an InputContext.
+     */
+    enum class InputLatency : size_t
+    {
+        /**
+         * \brief Cursor moves, dispatched when the element under the cursor is resolved.
+         */
+        Move = 0,
+
+        /**
+         * \brief Pointers entering or exiting the window.
+         */
+        Enter,
+
+        Click,
+
+        Scroll,
+
+        Key,
+
+        Text,
+
+        Count
+    };
+
+    inline constexpr size_t inputLatencyCount = static_cast<size_t>(InputLatency::Count);
+
+    /**
+     * \brief Value of every metric for a single frame, or accumulated over multiple frames.
+     */
+    struct InputFrameStats
+    {
+        std::array<uint64_t, inputMetricCount> values{};
+
+        [[nodiscard]] uint64_t& operator[](const InputMetric metric) noexcept
+        {
+            return values[static_cast<size_t>(metric)];
+        }
+
+        [[nodiscard]] uint64_t operator[](const InputMetric metric) const noexcept
+        {
+            return values[static_cast<size_t>(metric)];
+        }
+    };
+
+    /**
+     * \brief Histogram over the most recent values of a metric. Values are counted in power-of-two buckets: bucket 0
+     * holds 0 and bucket i holds values in [2^(i-1), 2^i).
+     */
+    class InputHistogram
+    {
+    public:
+        static constexpr size_t bucketCount = 65;
+
+        /**
+         * \brief Number of most recent values that are kept. Older values are removed from the histogram.
+         */
+        static constexpr size_t windowSize = 256;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InputHistogram();
+
+        InputHistogram(const InputHistogram&) = default;
+
+        InputHistogram(InputHistogram&&) noexcept = default;
+
+        ~InputHistogram() noexcept;
+
+        InputHistogram& operator=(const InputHistogram&) = default;
+
+        InputHistogram& operator=(InputHistogram&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of values in the window.
+         * \return Count.
+         */
+        [[nodiscard]] size_t getCount() const noexcept;
+
+        [[nodiscard]] std::span<const uint32_t, bucketCount> getBuckets() const noexcept;
+
+        [[nodiscard]] uint64_t getMax() const noexcept;
+
+        [[nodiscard]] double getMean() const noexcept;
+
+        /**
+         * \brief Get a percentile of the values in the window.
+         * \param p Percentile in [0, 1].
+         * \return Value, or 0 if the histogram is empty.
+         */
+        [[nodiscard]] uint64_t getPercentile(double p) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Histogram.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Add a value, removing the oldest value if the window is full.
+         * \param value Value.
+         */
+        void add(uint64_t value) noexcept;
+
+        void clear() noexcept;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::array<uint32_t, bucketCount> buckets{};
+
+        /**
+         * \brief Most recent values, used as a ring buffer.
+         */
+        std::array<uint64_t, windowSize> window{};
+
+        size_t head = 0;
+
+        size_t count = 0;
+    };
+
+    /**
+     * \brief Statistics collected by an InputContext. See InputContext::setStatsEnabled.
+     */
+    class InputStats
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InputStats();
+
+        InputStats(const InputStats&) = default;
+
+        InputStats(InputStats&&) noexcept = default;
+
+        ~InputStats() noexcept;
+
+        InputStats& operator=(const InputStats&) = default;
+
+        InputStats& operator=(InputStats&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of frames recorded since the last clear.
+         * \return Number of frames.
+         */
+        [[nodiscard]] size_t getFrameCount() const noexcept;
+
+        /**
+         * \brief Get the stats of the most recent frame.
+         * \return Frame stats.
+         */
+        [[nodiscard]] const InputFrameStats& getLastFrame() const noexcept;
+
+        /**
+         * \brief Get the stats of all frames since the last clear, summed.
+         * \return Summed stats.
+         */
+        [[nodiscard]] const InputFrameStats& getTotal() const noexcept;
+
+        /**
+         * \brief Get the histogram of a metric over the most recent frames.
+         * \param metric Metric.
+         * \return Histogram.
+         */
+        [[nodiscard]] const InputHistogram& getHistogram(InputMetric metric) const noexcept;
+
+        /**
+         * \brief Get the histogram of the latency in nanoseconds of the most recent events of a type.
+         * \param type Event type.
+         * \return Histogram.
+         */
+        [[nodiscard]] const InputHistogram& getLatencyHistogram(InputLatency type) const noexcept;
+
+        /**
+         * \brief Get the highest latency in nanoseconds of all events of a type since the last clear.
+         * \param type Event type.
+         * \return Latency.
+         */
+        [[nodiscard]] uint64_t getMaxLatency(InputLatency type) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Stats.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Record the stats of a frame.
+         * \param frame Frame stats.
+         */
+        void record(const InputFrameStats& frame) noexcept;
+
+        /**
+         * \brief Record the latency of a single event.
+         * \param type Event type.
+         * \param latency Latency in nanoseconds.
+         */
+        void recordLatency(InputLatency type, uint64_t latency) noexcept;
+
+        void clear() noexcept;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        size_t frameCount = 0;
+
+        InputFrameStats lastFrame;
+
+        InputFrameStats total;
+
+        std::array<InputHistogram, inputMetricCount> histograms;
+
+        std::array<InputHistogram, inputLatencyCount> latencies;
+
+        std::array<uint64_t, inputLatencyCount> maxLatencies{};
+    };
+}  // namespace floah
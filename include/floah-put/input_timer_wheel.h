@@ -0,0 +1,396 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace floah
+{
+    /**
+     * \brief Handle to a timer scheduled in an InputTimerWheel. A handle becomes invalid once its timer fired or was
+     * cancelled. Handles are never reused, because slots are reused with a new generation.
+     */
+    struct InputTimerHandle
+    {
+        static constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * \brief Slot index.
+         */
+        uint32_t index = invalidIndex;
+
+        /**
+         * \brief Generation of the slot at the time the handle was created.
+         */
+        uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const noexcept { return index != invalidIndex; }
+
+        [[nodiscard]] bool operator==(const InputTimerHandle&) const noexcept = default;
+    };
+
+    /**
+     * \brief Hierarchical timer wheel. Scheduling and cancelling a timer are O(1). Advancing the wheel only visits
+     * slots that contain timers, so that it costs (almost) nothing while no timer expires, regardless of the number of
+     * scheduled timers.
+     *
+     * The wheel has a number of levels of 64 slots. A slot on level l spans 64^l time units. A timer is stored on the
+     * lowest level on which its deadline shares all higher digits (in base 64) with the current time of the wheel, and
+     * moved down to lower levels as the time approaches its deadline.
+     * \tparam T Value type of timers.
+     */
+    template<typename T>
+    class InputTimerWheel
+    {
+    public:
+        /**
+         * \brief Timer that expired during advance.
+         */
+        struct Expired
+        {
+            InputTimerHandle handle;
+
+            int64_t deadline = 0;
+
+            T value{};
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty wheel.
+         * \param resource Resource to allocate timers from.
+         */
+        explicit InputTimerWheel(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+            nodes(resource), order(resource), indices(resource), sorted(resource)
+        {
+            heads.fill(none);
+        }
+
+        InputTimerWheel(const InputTimerWheel&) = delete;
+
+        InputTimerWheel(InputTimerWheel&&) noexcept = default;
+
+        ~InputTimerWheel() noexcept = default;
+
+        InputTimerWheel& operator=(const InputTimerWheel&) = delete;
+
+        InputTimerWheel& operator=(InputTimerWheel&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of scheduled timers.
+         * \return Number of timers.
+         */
+        [[nodiscard]] size_t size() const noexcept { return count; }
+
+        [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+        /**
+         * \brief Get the time the wheel was last advanced to.
+         * \return Time.
+         */
+        [[nodiscard]] int64_t getTime() const noexcept { return elapsed; }
+
+        /**
+         * \brief Returns whether a timer is still scheduled.
+         * \param handle Handle.
+         * \return True if scheduled.
+         */
+        [[nodiscard]] bool contains(const InputTimerHandle handle) const noexcept
+        {
+            return handle.index < nodes.size() && nodes[handle.index].generation == handle.generation &&
+                   nodes[handle.index].slot != freeSlot;
+        }
+
+        /**
+         * \brief Get a lower bound of the earliest deadline of all scheduled timers. Advancing to a time before it
+         * does not expire any timer.
+         * \return Lower bound, or the maximum value if no timers are scheduled.
+         */
+        [[nodiscard]] int64_t getNextExpiration() const noexcept
+        {
+            if (heads[expiredSlot] != none) return elapsed;
+            for (uint32_t level = 0; level < levelCount; level++)
+            {
+                if (occupied[level] == 0) continue;
+
+                // All occupied slots are past the slot of the current time. The earliest one starts at the current
+                // time with the digit of this level replaced and all lower digits cleared.
+                const auto slot  = static_cast<uint64_t>(std::countr_zero(occupied[level]));
+                const auto shift = level * levelBits;
+                const auto high  = shift + levelBits >= 64 ? 0 : ~((uint64_t{1} << (shift + levelBits)) - 1);
+                return fromKey((toKey(elapsed) & high) | (slot << shift));
+            }
+            return std::numeric_limits<int64_t>::max();
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Modifiers.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Schedule a timer. Timers with a deadline at or before the current time expire on the next advance.
+         * \param deadline Deadline.
+         * \param value Value.
+         * \return Handle.
+         */
+        InputTimerHandle schedule(const int64_t deadline, const T& value)
+        {
+            uint32_t index;
+            if (freeList != none)
+            {
+                index    = freeList;
+                freeList = nodes[index].next;
+            }
+            else
+            {
+                index = static_cast<uint32_t>(nodes.size());
+                nodes.emplace_back();
+            }
+
+            auto& node    = nodes[index];
+            node.deadline = deadline;
+            node.sequence = sequence++;
+            node.value    = value;
+            insert(index);
+            count++;
+            return InputTimerHandle{.index = index, .generation = node.generation};
+        }
+
+        /**
+         * \brief Cancel a timer.
+         * \param handle Handle.
+         * \return True if the timer was cancelled, false if it already expired or was cancelled.
+         */
+        bool cancel(const InputTimerHandle handle) noexcept
+        {
+            if (!contains(handle)) return false;
+            unlink(handle.index);
+            release(handle.index);
+            return true;
+        }
+
+        /**
+         * \brief Advance the current time and collect all timers that expired. Timers are appended in order of their
+         * deadline, and timers with the same deadline in the order in which they were scheduled. The wheel never goes
+         * back in time.
+         * \param time Time.
+         * \param expired List to append expired timers to.
+         */
+        void advance(const int64_t time, std::pmr::vector<Expired>& expired)
+        {
+            const auto first = expired.size();
+            while (true)
+            {
+                // Timers that were moved to the expired slot.
+                for (auto index = std::exchange(heads[expiredSlot], none); index != none;)
+                {
+                    const auto next = nodes[index].next;
+                    expired.emplace_back(Expired{.handle   = {.index = index, .generation = nodes[index].generation},
+                                                 .deadline = nodes[index].deadline,
+                                                 .value    = nodes[index].value});
+                    order.emplace_back(nodes[index].sequence);
+                    release(index);
+                    index = next;
+                }
+
+                const auto next = getNextExpiration();
+                if (next > time || count == 0)
+                {
+                    elapsed = std::max(elapsed, time);
+                    break;
+                }
+
+                // Move to the start of the earliest occupied slot and redistribute its timers over lower levels.
+                elapsed = next;
+                for (uint32_t level = 0; level < levelCount; level++)
+                {
+                    if (occupied[level] == 0) continue;
+                    const auto slot = level * slotCount + static_cast<uint32_t>(std::countr_zero(occupied[level]));
+                    occupied[level] &= occupied[level] - 1;
+                    for (auto index = std::exchange(heads[slot], none); index != none;)
+                    {
+                        const auto n = nodes[index].next;
+                        insert(index);
+                        index = n;
+                    }
+                    break;
+                }
+            }
+
+            // Slots are not ordered internally.
+            if (expired.size() - first > 1)
+            {
+                indices.resize(expired.size() - first);
+                for (size_t i = 0; i < indices.size(); i++) indices[i] = i;
+                std::ranges::sort(indices, [&](const size_t a, const size_t b) {
+                    const auto& ea = expired[first + a];
+                    const auto& eb = expired[first + b];
+                    return ea.deadline != eb.deadline ? ea.deadline < eb.deadline : order[a] < order[b];
+                });
+                sorted.clear();
+                for (const auto i : indices) sorted.emplace_back(expired[first + i]);
+                std::ranges::copy(sorted, expired.begin() + static_cast<ptrdiff_t>(first));
+            }
+            order.clear();
+        }
+
+        /**
+         * \brief Cancel all timers.
+         */
+        void clear() noexcept
+        {
+            for (uint32_t index = 0; index < nodes.size(); index++)
+                if (nodes[index].slot != freeSlot) release(index);
+            heads.fill(none);
+            occupied.fill(0);
+        }
+
+    private:
+        static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+        static constexpr uint32_t levelBits = 6;
+
+        static constexpr uint32_t slotCount = 1u << levelBits;
+
+        static constexpr uint32_t levelCount = (64 + levelBits - 1) / levelBits;
+
+        /**
+         * \brief Slot of timers whose deadline has passed.
+         */
+        static constexpr uint32_t expiredSlot = levelCount * slotCount;
+
+        static constexpr uint32_t freeSlot = none;
+
+        struct Node
+        {
+            int64_t deadline = 0;
+
+            /**
+             * \brief Order in which timers were scheduled.
+             */
+            uint64_t sequence = 0;
+
+            uint32_t generation = 0;
+
+            /**
+             * \brief Slot the timer is in, or freeSlot.
+             */
+            uint32_t slot = freeSlot;
+
+            uint32_t prev = none;
+
+            uint32_t next = none;
+
+            T value{};
+        };
+
+        /**
+         * \brief Map a time to an unsigned key with the same order.
+         */
+        [[nodiscard]] static uint64_t toKey(const int64_t time) noexcept
+        {
+            return static_cast<uint64_t>(time) ^ (uint64_t{1} << 63);
+        }
+
+        [[nodiscard]] static int64_t fromKey(const uint64_t key) noexcept
+        {
+            return static_cast<int64_t>(key ^ (uint64_t{1} << 63));
+        }
+
+        void insert(const uint32_t index) noexcept
+        {
+            auto& node = nodes[index];
+
+            uint32_t slot = expiredSlot;
+            if (node.deadline > elapsed)
+            {
+                // Level of the highest digit in which the deadline differs from the current time.
+                const auto key      = toKey(node.deadline);
+                const auto level    = static_cast<uint32_t>(63 - std::countl_zero(key ^ toKey(elapsed))) / levelBits;
+                const auto position = static_cast<uint32_t>(key >> (level * levelBits)) & (slotCount - 1);
+                slot                = level * slotCount + position;
+                occupied[level] |= uint64_t{1} << position;
+            }
+
+            node.slot = slot;
+            node.prev = none;
+            node.next = heads[slot];
+            if (node.next != none) nodes[node.next].prev = index;
+            heads[slot] = index;
+        }
+
+        void unlink(const uint32_t index) noexcept
+        {
+            const auto& node = nodes[index];
+            if (node.prev != none)
+                nodes[node.prev].next = node.next;
+            else
+                heads[node.slot] = node.next;
+            if (node.next != none) nodes[node.next].prev = node.prev;
+
+            // Clear the occupied bit of a slot that became empty.
+            if (node.slot != expiredSlot && heads[node.slot] == none)
+                occupied[node.slot / slotCount] &= ~(uint64_t{1} << (node.slot % slotCount));
+        }
+
+        void release(const uint32_t index) noexcept
+        {
+            auto& node = nodes[index];
+            node.slot  = freeSlot;
+            node.generation++;
+            node.next = freeList;
+            freeList  = index;
+            count--;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::pmr::vector<Node> nodes;
+
+        /**
+         * \brief First node of each slot, followed by the expired slot.
+         */
+        std::array<uint32_t, levelCount * slotCount + 1> heads{};
+
+        /**
+         * \brief Bit mask of non-empty slots per level.
+         */
+        std::array<uint64_t, levelCount> occupied{};
+
+        uint32_t freeList = none;
+
+        size_t count = 0;
+
+        uint64_t sequence = 0;
+
+        int64_t elapsed = 0;
+
+        /**
+         * \brief Scratch space for sorting expired timers.
+         */
+        std::pmr::vector<uint64_t> order;
+
+        std::pmr::vector<size_t> indices;
+
+        std::pmr::vector<Expired> sorted;
+    };
+}  // namespace floah
@@ -0,0 +1,113 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_stats.h"
+
+namespace floah
+{
+    /**
+     * \brief Span of a single event dispatched by an InputContext. All times are in nanoseconds of
+     * std::chrono::steady_clock.
+     */
+    struct InputEventTrace
+    {
+        InputLatency type = InputLatency::Move;
+
+        /**
+         * \brief Pointer the event belongs to. Always the mouse pointer for key and text events.
+         */
+        uint32_t pointer = 0;
+
+        /**
+         * \brief Source timestamp of the event (see InputContext::setTimestamp).
+         */
+        int64_t timestamp = 0;
+
+        /**
+         * \brief Time at which dispatching to elements started.
+         */
+        int64_t start = 0;
+
+        /**
+         * \brief Time at which all handlers of the event returned.
+         */
+        int64_t end = 0;
+    };
+
+    /**
+     * \brief Spans of a single frame, i.e. a call to InputContext::postPoll.
+     */
+    struct InputFrameTrace
+    {
+        /**
+         * \brief Number of the frame, counting from 1.
+         */
+        uint64_t frame = 0;
+
+        /**
+         * \brief Time at which postPoll was called.
+         */
+        int64_t start = 0;
+
+        /**
+         * \brief Time at which postPoll returned.
+         */
+        int64_t end = 0;
+
+        /**
+         * \brief Number of events passed to element event handlers.
+         */
+        size_t dispatchedEvents = 0;
+
+        /**
+         * \brief Events with a source timestamp, in order of dispatch. Only valid during the call to
+         * InputTracer::traceFrame.
+         */
+        std::span<const InputEventTrace> events;
+    };
+
+    /**
+     * \brief Receives the spans of every frame of an InputContext, e.g. to write them to a file for offline analysis.
+     * See InputContext::setTracer.
+     */
+    class InputTracer
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InputTracer();
+
+        InputTracer(const InputTracer&) = default;
+
+        InputTracer(InputTracer&&) noexcept = default;
+
+        virtual ~InputTracer() noexcept;
+
+        InputTracer& operator=(const InputTracer&) = default;
+
+        InputTracer& operator=(InputTracer&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Trace.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Called at the end of every postPoll.
+         * \param frame Spans of the frame.
+         */
+        virtual void traceFrame(const InputFrameTrace& frame) = 0;
+    };
+}  // namespace floah
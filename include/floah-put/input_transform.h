@@ -0,0 +1,28 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "math/include_all.h"
+
+namespace floah
+{
+    /**
+     * \brief Transformation from global space to the local space of an input element.
+     */
+    struct InputTransform
+    {
+        /**
+         * \brief Offset of the element in global space (see InputElement::getInputOffset).
+         */
+        math::int2 offset;
+
+        /**
+         * \brief Transform a point from global to local space.
+         * \param point Point in global space.
+         * \return Point in local space.
+         */
+        [[nodiscard]] math::int2 toLocal(const math::int2 point) const noexcept { return point - offset; }
+    };
+}  // namespace floah
@@ -0,0 +1,123 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_handle.h"
+#include "floah-put/input_transform.h"
+
+namespace floah
+{
+    class InputElement;
+    class InputTree;
+
+    /**
+     * \brief Cached global transforms of input elements, stored contiguously by handle index.
+     *
+     * Transforms are calculated once when the cache is built. Afterwards, only elements marked dirty and their
+     * descendants are recalculated.
+     */
+    class InputTransformCache
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty cache.
+         * \param resource Resource to allocate transforms from.
+         */
+        explicit InputTransformCache(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        InputTransformCache(const InputTransformCache&) = delete;
+
+        InputTransformCache(InputTransformCache&&) noexcept = delete;
+
+        ~InputTransformCache() noexcept;
+
+        InputTransformCache& operator=(const InputTransformCache&) = delete;
+
+        InputTransformCache& operator=(InputTransformCache&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the cached transform of an element. Elements that were not in the tree the cache was last built
+         * from and were not marked dirty since (e.g. added since) are calculated directly.
+         * \param elem Element.
+         * \param handle Handle of element.
+         * \return Transform.
+         */
+        [[nodiscard]] InputTransform get(const InputElement& elem, InputHandle handle) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Cache.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Recalculate the transforms of all elements in a tree.
+         * \param tree Element tree.
+         * \param slotCount Number of handle slots in the element registry.
+         */
+        void build(const InputTree& tree, size_t slotCount);
+
+        /**
+         * \brief Mark the transform of an element and all its descendants as dirty.
+         * \param elem Element. Does not have to be in the context itself.
+         */
+        void markDirty(const InputElement& elem);
+
+        /**
+         * \brief Recalculate the transforms of all dirty elements.
+         * \param tree Element tree, kept up to date since the cache was built.
+         * \return True if any transform was recalculated.
+         */
+        bool refresh(const InputTree& tree);
+
+        /**
+         * \brief Clear the cache.
+         */
+        void clear() noexcept;
+
+    private:
+        /**
+         * \brief Calculate and store the transform of an element, growing the cache if needed.
+         * \param elem Element.
+         * \param handle Handle of element.
+         */
+        void set(const InputElement& elem, InputHandle handle);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Transforms by handle index.
+         */
+        std::pmr::vector<InputTransform> transforms;
+
+        /**
+         * \brief Handle each transform was calculated for, to detect slots that were reused since.
+         */
+        std::pmr::vector<InputHandle> handles;
+
+        /**
+         * \brief Elements marked dirty since the last refresh.
+         */
+        std::pmr::vector<const InputElement*> dirty;
+
+    };
+}  // namespace floah
@@ -0,0 +1,194 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_handle.h"
+
+namespace floah
+{
+    class InputElement;
+
+    /**
+     * \brief Tree of input elements, built from InputElement::getInputParent. Ancestors of elements that were not added
+     * to the context are part of the tree as well, as long as they have a descendant that was.
+     *
+     * The tree can be rebuilt from a list of elements, or kept up to date as elements are inserted, erased and
+     * reparented. Node indices stay valid until the node is erased or the tree is rebuilt. Children are linked lists in
+     * no particular order.
+     */
+    class InputTree
+    {
+    public:
+        static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+        struct Node
+        {
+            /**
+             * \brief Element, or nullptr if the node is unused.
+             */
+            const InputElement* element = nullptr;
+
+            uint32_t parent = none;
+
+            /**
+             * \brief Handle of element, or invalid handle if it was not added.
+             */
+            InputHandle handle{};
+
+            uint32_t firstChild = none;
+
+            /**
+             * \brief Next sibling. Roots are siblings of each other. Unused nodes are linked into a free list.
+             */
+            uint32_t nextSibling = none;
+
+            uint32_t previousSibling = none;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Construct an empty tree.
+         * \param resource Resource to allocate nodes and the lookup table from.
+         */
+        explicit InputTree(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        InputTree(const InputTree&) = delete;
+
+        InputTree(InputTree&&) noexcept = delete;
+
+        ~InputTree() noexcept;
+
+        InputTree& operator=(const InputTree&) = delete;
+
+        InputTree& operator=(InputTree&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get all nodes, including unused ones.
+         * \return Nodes.
+         */
+        [[nodiscard]] std::span<const Node> getNodes() const noexcept;
+
+        /**
+         * \brief Get the first node without parent. The others follow as its siblings.
+         * \return Root node index or none.
+         */
+        [[nodiscard]] uint32_t getFirstRoot() const noexcept;
+
+        /**
+         * \brief Get the node that follows a node in a top-down walk of a subtree, in which every node is visited after
+         * its parent.
+         * \param node Current node.
+         * \param root Root of walked subtree.
+         * \return Next node index, or none if the walk is done.
+         */
+        [[nodiscard]] uint32_t getNext(uint32_t node, uint32_t root) const noexcept;
+
+        /**
+         * \brief Get the node of an element.
+         * \param elem Element.
+         * \return Node index or none.
+         */
+        [[nodiscard]] uint32_t find(const InputElement& elem) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Tree.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Rebuild the tree.
+         * \param elements Elements.
+         * \param handles Handles of elements.
+         */
+        void build(std::span<InputElement* const> elements, std::span<const InputHandle> handles);
+
+        /**
+         * \brief Insert an element, creating nodes for any of its ancestors that are missing.
+         * \param elem Element.
+         * \param handle Handle of element.
+         */
+        void insert(const InputElement& elem, InputHandle handle);
+
+        /**
+         * \brief Erase an element. Its node is kept while it has children. Ancestors that are left without descendants
+         * that were added are erased as well.
+         * \param elem Element. Does not have to be in the tree.
+         */
+        void erase(const InputElement& elem);
+
+        /**
+         * \brief Move the node of an element, along with its subtree, below its current parent.
+         * \param elem Element. Does not have to be in the tree.
+         */
+        void reparent(const InputElement& elem);
+
+        /**
+         * \brief Clear the tree.
+         */
+        void clear() noexcept;
+
+    private:
+        /**
+         * \brief Get node of an element, creating it and any missing ancestors.
+         * \param elem Element.
+         * \return Node index.
+         */
+        uint32_t getNode(const InputElement& elem);
+
+        /**
+         * \brief Add a node to the children of a parent, or to the roots.
+         * \param node Node index.
+         * \param parent Parent node index or none.
+         */
+        void link(uint32_t node, uint32_t parent) noexcept;
+
+        /**
+         * \brief Remove a node from the children of its parent, or from the roots.
+         * \param node Node index.
+         */
+        void unlink(uint32_t node) noexcept;
+
+        /**
+         * \brief Erase a node and its ancestors for as long as they have no children and were not added.
+         * \param node Node index or none.
+         */
+        void prune(uint32_t node);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::pmr::vector<Node> nodes;
+
+        /**
+         * \brief Node index by element.
+         */
+        std::pmr::unordered_map<const InputElement*, uint32_t> lookup;
+
+        uint32_t firstRoot = none;
+
+        /**
+         * \brief First unused node.
+         */
+        uint32_t firstFree = none;
+    };
+}  // namespace floah
@@ -0,0 +1,137 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace floah
+{
+    /**
+     * \brief Fixed set of worker threads that run batches of tasks. Used by InputContext to hit-test large element sets
+     * on multiple cores (see InputContext::setWorkerPool).
+     *
+     * A batch is started with run, which blocks until all of its tasks are finished. The calling thread executes tasks
+     * as well. Only one thread may call run at a time, so a pool shared between contexts must only be used by contexts
+     * that are polled from the same thread.
+     */
+    class InputWorkerPool
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Start the worker threads.
+         * \param threadCount Number of threads in addition to the calling thread.
+         */
+        explicit InputWorkerPool(size_t threadCount);
+
+        InputWorkerPool(const InputWorkerPool&) = delete;
+
+        InputWorkerPool(InputWorkerPool&&) noexcept = delete;
+
+        /**
+         * \brief Stop and join the worker threads.
+         */
+        ~InputWorkerPool() noexcept;
+
+        InputWorkerPool& operator=(const InputWorkerPool&) = delete;
+
+        InputWorkerPool& operator=(InputWorkerPool&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of worker threads, excluding the thread calling run.
+         * \return Number of threads.
+         */
+        [[nodiscard]] size_t getThreadCount() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Run.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Run a number of tasks and wait for all of them to finish. Tasks are started in order of their index,
+         * but can finish in any order.
+         * \tparam F Callable taking the task index.
+         * \param taskCount Number of tasks.
+         * \param task Task. Must not throw.
+         */
+        template<typename F>
+        void run(const size_t taskCount, F&& task)
+        {
+            using T = std::remove_reference_t<F>;
+            runTasks(
+              taskCount,
+              [](void* t, const size_t index) { (*static_cast<T*>(t))(index); },
+              const_cast<void*>(static_cast<const void*>(std::addressof(task))));
+        }
+
+    private:
+        using Task = void (*)(void*, size_t);
+
+        void runTasks(size_t taskCount, Task task, void* data);
+
+        /**
+         * \brief Execute tasks of the current batch until none are left.
+         */
+        void execute() noexcept;
+
+        void work();
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::vector<std::thread> threads;
+
+        std::mutex mutex;
+
+        /**
+         * \brief Signals workers that a batch was started or the pool is stopping.
+         */
+        std::condition_variable started;
+
+        /**
+         * \brief Signals the calling thread that all workers are done with the current batch.
+         */
+        std::condition_variable finished;
+
+        /**
+         * \brief Incremented for every batch, so that workers can tell a new batch from a spurious wakeup.
+         */
+        uint64_t batch = 0;
+
+        /**
+         * \brief Number of workers that have not yet finished the current batch.
+         */
+        size_t busy = 0;
+
+        bool stopping = false;
+
+        Task batchTask = nullptr;
+
+        void* batchData = nullptr;
+
+        size_t batchSize = 0;
+
+        /**
+         * \brief Index of the next task to execute.
+         */
+        std::atomic<size_t> next = 0;
+    };
+}  // namespace floah
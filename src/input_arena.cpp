@@ -0,0 +1,102 @@
+#include "floah-put/input_arena.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputArena::InputArena(std::pmr::memory_resource* resource, const size_t size) noexcept :
+        upstream(resource), blockSize(std::max(size, sizeof(Block)))
+    {
+    }
+
+    InputArena::~InputArena() noexcept { release(); }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::pmr::memory_resource* InputArena::getUpstream() const noexcept { return upstream; }
+
+    size_t InputArena::getCapacity() const noexcept { return capacity; }
+
+    size_t InputArena::getSize() const noexcept
+    {
+        return blocks ? filled + static_cast<size_t>(cursor - reinterpret_cast<std::byte*>(blocks + 1)) : 0;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Memory.
+    ////////////////////////////////////////////////////////////////
+
+    void InputArena::reset() noexcept
+    {
+        // Replace multiple blocks by a single one that fits everything, so that the next cycle only needs one.
+        if (blockCount > 1)
+        {
+            const auto total = capacity;
+            release();
+            blockSize = total;
+            return;
+        }
+
+        filled = 0;
+        if (blocks)
+        {
+            cursor = reinterpret_cast<std::byte*>(blocks + 1);
+            end    = reinterpret_cast<std::byte*>(blocks) + blocks->size;
+        }
+    }
+
+    void InputArena::release() noexcept
+    {
+        while (blocks)
+        {
+            auto* block = blocks;
+            blocks      = block->next;
+            upstream->deallocate(block, block->size, alignof(std::max_align_t));
+        }
+
+        blockCount = 0;
+        capacity   = 0;
+        filled     = 0;
+        cursor     = nullptr;
+        end        = nullptr;
+    }
+
+    void* InputArena::do_allocate(const size_t bytes, const size_t alignment)
+    {
+        const auto padding = [&] { return (0 - reinterpret_cast<uintptr_t>(cursor)) & (alignment - 1); };
+        if (static_cast<size_t>(end - cursor) < padding() + bytes)
+        {
+            // The remainder of the current block is lost until the next reset.
+            if (blocks) filled += static_cast<size_t>(end - reinterpret_cast<std::byte*>(blocks + 1));
+
+            const auto size   = std::max(blockSize, sizeof(Block) + bytes + alignment);
+            auto*      memory = upstream->allocate(size, alignof(std::max_align_t));
+            blocks            = new (memory) Block{.next = blocks, .size = size};
+            blockCount++;
+            capacity += size;
+            blockSize = size * 2;
+            cursor    = reinterpret_cast<std::byte*>(blocks + 1);
+            end       = reinterpret_cast<std::byte*>(blocks) + size;
+        }
+
+        auto* p = cursor + padding();
+        cursor  = p + bytes;
+        return p;
+    }
+
+    void InputArena::do_deallocate(void*, size_t, size_t) {}
+
+    bool InputArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept { return this == &other; }
+}  // namespace floah
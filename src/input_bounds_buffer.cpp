@@ -0,0 +1,181 @@
+#include "floah-put/input_bounds_buffer.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLOAH_PUT_SSE2
+#include <emmintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_element.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputBoundsBuffer::InputBoundsBuffer(std::pmr::memory_resource* resource) :
+        lowerX(resource), lowerY(resource), upperX(resource), upperY(resource)
+    {
+    }
+
+    InputBoundsBuffer::~InputBoundsBuffer() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    InputBounds InputBoundsBuffer::getBounds(const size_t index) const noexcept
+    {
+        return InputBounds{.lower = math::int2(lowerX[index], lowerY[index]),
+                           .upper = math::int2(upperX[index], upperY[index])};
+    }
+
+    size_t InputBoundsBuffer::getBlockCount() const noexcept { return lowerX.size() / blockSize; }
+
+    ////////////////////////////////////////////////////////////////
+    // Buffer.
+    ////////////////////////////////////////////////////////////////
+
+    void InputBoundsBuffer::build(const std::span<InputElement* const> elements,
+                                  const std::span<const math::int2> offsets)
+    {
+        constexpr auto min  = std::numeric_limits<int32_t>::min();
+        constexpr auto max  = std::numeric_limits<int32_t>::max();
+        const auto     size = (elements.size() + blockSize - 1) / blockSize * blockSize;
+
+        // Padding is initialized to inverted bounds.
+        lowerX.assign(size, max);
+        lowerY.assign(size, max);
+        upperX.assign(size, min);
+        upperY.assign(size, min);
+
+        for (size_t i = 0; i < elements.size(); i++) update(i, *elements[i], offsets[i]);
+    }
+
+    void InputBoundsBuffer::resize(const size_t count)
+    {
+        constexpr auto min  = std::numeric_limits<int32_t>::min();
+        constexpr auto max  = std::numeric_limits<int32_t>::max();
+        const auto     size = (count + blockSize - 1) / blockSize * blockSize;
+
+        lowerX.resize(size);
+        lowerY.resize(size);
+        upperX.resize(size);
+        upperY.resize(size);
+
+        // Padding is set to inverted bounds.
+        for (auto i = count; i < size; i++)
+        {
+            lowerX[i] = max;
+            lowerY[i] = max;
+            upperX[i] = min;
+            upperY[i] = min;
+        }
+    }
+
+    void InputBoundsBuffer::update(const size_t index, const InputElement& elem, const math::int2 offset) noexcept
+    {
+        constexpr auto min = std::numeric_limits<int32_t>::min();
+        constexpr auto max = std::numeric_limits<int32_t>::max();
+
+        // Elements without bounds get bounds covering (almost) everything.
+        const auto bounds = elem.getInputBounds();
+        const auto b      = bounds ? bounds->translate(offset) :
+                                     InputBounds{.lower = math::int2(min, min), .upper = math::int2(max, max)};
+        lowerX[index] = b.lower.x;
+        lowerY[index] = b.lower.y;
+        upperX[index] = b.upper.x;
+        upperY[index] = b.upper.y;
+    }
+
+    void InputBoundsBuffer::clear() noexcept
+    {
+        lowerX.clear();
+        lowerY.clear();
+        upperX.clear();
+        upperY.clear();
+    }
+
+    uint32_t InputBoundsBuffer::test(const size_t block, const math::int2 point) const noexcept
+    {
+        const auto offset = block * blockSize;
+
+#ifdef FLOAH_PUT_SSE2
+        const auto px   = _mm_set1_epi32(point.x);
+        const auto py   = _mm_set1_epi32(point.y);
+        uint32_t   mask = 0;
+        for (size_t i = 0; i < blockSize; i += 4)
+        {
+            const auto lx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowerX.data() + offset + i));
+            const auto ly = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowerY.data() + offset + i));
+            const auto ux = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upperX.data() + offset + i));
+            const auto uy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upperY.data() + offset + i));
+
+            // lower <= point < upper, written as !(lower > point) && upper > point.
+            const auto outside = _mm_or_si128(_mm_cmpgt_epi32(lx, px), _mm_cmpgt_epi32(ly, py));
+            const auto inside  = _mm_and_si128(_mm_cmpgt_epi32(ux, px), _mm_cmpgt_epi32(uy, py));
+            const auto result  = _mm_andnot_si128(outside, inside);
+            mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(result))) << i;
+        }
+        return mask;
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < blockSize; i++)
+        {
+            const auto j = offset + i;
+            const auto inside =
+              point.x >= lowerX[j] && point.y >= lowerY[j] && point.x < upperX[j] && point.y < upperY[j];
+            mask |= static_cast<uint32_t>(inside) << i;
+        }
+        return mask;
+#endif
+    }
+
+    uint32_t InputBoundsBuffer::test(const size_t block, const InputBounds& region) const noexcept
+    {
+        const auto offset = block * blockSize;
+
+#ifdef FLOAH_PUT_SSE2
+        const auto rlx  = _mm_set1_epi32(region.lower.x);
+        const auto rly  = _mm_set1_epi32(region.lower.y);
+        const auto rux  = _mm_set1_epi32(region.upper.x);
+        const auto ruy  = _mm_set1_epi32(region.upper.y);
+        uint32_t   mask = 0;
+        for (size_t i = 0; i < blockSize; i += 4)
+        {
+            const auto lx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowerX.data() + offset + i));
+            const auto ly = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowerY.data() + offset + i));
+            const auto ux = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upperX.data() + offset + i));
+            const auto uy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upperY.data() + offset + i));
+
+            // lower < region.upper && region.lower < upper on both axes.
+            const auto lower  = _mm_and_si128(_mm_cmpgt_epi32(rux, lx), _mm_cmpgt_epi32(ruy, ly));
+            const auto upper  = _mm_and_si128(_mm_cmpgt_epi32(ux, rlx), _mm_cmpgt_epi32(uy, rly));
+            const auto result = _mm_and_si128(lower, upper);
+            mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(result))) << i;
+        }
+        return mask;
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < blockSize; i++)
+        {
+            const auto j = offset + i;
+            const auto overlaps =
+              lowerX[j] < region.upper.x && lowerY[j] < region.upper.y && region.lower.x < upperX[j] &&
+              region.lower.y < upperY[j];
+            mask |= static_cast<uint32_t>(overlaps) << i;
+        }
+        return mask;
+#endif
+    }
+}  // namespace floah
@@ -4,13 +4,165 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
-#include <ranges>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <utility>
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
 #include "floah-put/input_element.h"
+#include "floah-put/input_producer.h"
+#include "floah-put/input_recorder.h"
+#include "floah-put/input_worker_pool.h"
+
+namespace
+{
+#ifdef FLOAH_PUT_STATS
+    constexpr bool statsSupported = true;
+#else
+    constexpr bool statsSupported = false;
+#endif
+
+    /**
+     * \brief Adds the time between construction and destruction to a value, if enabled.
+     */
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(const bool enabled, uint64_t& counter) noexcept : value(enabled ? &counter : nullptr)
+        {
+            if (value) start = std::chrono::steady_clock::now();
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+
+        ScopedTimer(ScopedTimer&&) noexcept = delete;
+
+        ~ScopedTimer() noexcept
+        {
+            if (!value) return;
+            const auto duration = std::chrono::steady_clock::now() - start;
+            *value += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+        }
+
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ScopedTimer& operator=(ScopedTimer&&) noexcept = delete;
+
+    private:
+        uint64_t* value;
+
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /**
+     * \brief Get the current time in nanoseconds of std::chrono::steady_clock.
+     */
+    [[nodiscard]] int64_t steadyNow() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+    }
+
+    /**
+     * \brief Round a precise position down to whole pixels.
+     */
+    [[nodiscard]] math::int2 toPixels(const math::int2 precise) noexcept
+    {
+        static_assert(std::has_single_bit(static_cast<uint32_t>(floah::InputContext::subpixelScale)));
+        constexpr auto shift = std::countr_zero(static_cast<uint32_t>(floah::InputContext::subpixelScale));
+
+        // Shifting rounds towards negative infinity, so that every pixel covers the same range of precise positions.
+        return math::int2(precise.x >> shift, precise.y >> shift);
+    }
+
+    /**
+     * \brief Empty lists allocated from an arena and reset the arena. The lists reserve their previous capacity again
+     * afterwards, so that the arena settles on a single block that fits all of them.
+     * \param arena Arena.
+     * \param lists Lists. Must be all lists that were allocated from the arena.
+     */
+    template<typename... Ts>
+    void resetArena(floah::InputArena& arena, std::pmr::vector<Ts>&... lists)
+    {
+        const std::array capacities{lists.capacity()...};
+        ((lists = std::pmr::vector<Ts>(&arena)), ...);
+        arena.reset();
+        size_t i = 0;
+        (lists.reserve(capacities[i++]), ...);
+    }
+
+    /**
+     * \brief Decode UTF-8 text, replacing invalid, overlong and incomplete sequences by U+FFFD.
+     * \tparam F Callable taking a codepoint.
+     * \param utf8 Text.
+     * \param f Callable.
+     */
+    template<typename F>
+    void decodeUtf8(const std::string_view utf8, F&& f)
+    {
+        constexpr char32_t replacement = 0xfffd;
+
+        for (size_t i = 0; i < utf8.size();)
+        {
+            const auto lead = static_cast<uint8_t>(utf8[i]);
+            if (lead < 0x80)
+            {
+                f(static_cast<char32_t>(lead));
+                i++;
+                continue;
+            }
+
+            // Length of the sequence and the smallest codepoint it can encode.
+            size_t   length = 0;
+            char32_t cp     = 0;
+            char32_t min    = 0;
+            if ((lead & 0xe0) == 0xc0)
+            {
+                length = 2;
+                cp     = lead & 0x1f;
+                min    = 0x80;
+            }
+            else if ((lead & 0xf0) == 0xe0)
+            {
+                length = 3;
+                cp     = lead & 0x0f;
+                min    = 0x800;
+            }
+            else if ((lead & 0xf8) == 0xf0)
+            {
+                length = 4;
+                cp     = lead & 0x07;
+                min    = 0x10000;
+            }
+            else
+            {
+                f(replacement);
+                i++;
+                continue;
+            }
+
+            size_t n = 1;
+            for (; n < length && i + n < utf8.size(); n++)
+            {
+                const auto b = static_cast<uint8_t>(utf8[i + n]);
+                if ((b & 0xc0) != 0x80) break;
+                cp = cp << 6 | (b & 0x3f);
+            }
+
+            const auto valid = n == length && cp >= min && cp <= 0x10ffff && (cp < 0xd800 || cp > 0xdfff);
+            f(valid ? cp : replacement);
+            i += n;
+        }
+    }
+}  // namespace
 
 namespace floah
 {
@@ -18,7 +170,47 @@ namespace floah
     // Constructors.
     ////////////////////////////////////////////////////////////////
 
-    InputContext::InputContext() = default;
+    InputContext::InputContext() : InputContext(std::pmr::get_default_resource()) {}
+
+    InputContext::InputContext(std::pmr::memory_resource* resource) :
+        allocationCounter(resource),
+        elementPool(&allocationCounter),
+        frameArena(&allocationCounter),
+        elementRegistry(&elementPool),
+        inputElements(&elementPool),
+        tree(&elementPool),
+        transforms(&elementPool),
+        propagationPaths(&elementPool),
+        propagationPath(&frameArena),
+        offsets(&frameArena),
+        dirtyBounds(&elementPool),
+        dirtyOffsets(&elementPool),
+        removedHandles(&elementPool),
+        boundsBuffer(&elementPool),
+        shapeBuffer(&elementPool),
+        spatialIndex(&elementPool),
+        hierarchy(&elementPool),
+        candidates(&frameArena),
+        pointers(&elementPool),
+        scanningPointers(&frameArena),
+        events(eventCapacity, &elementPool),
+        traceEvents(&frameArena),
+        scanChunks(&elementPool),
+        queryChunks(&allocationCounter),
+        queryBounds(&frameArena),
+        subtreeHandles(&frameArena),
+        timers(&elementPool),
+        expiredTimers(&frameArena),
+        focusChain(&elementPool),
+        text(&elementPool),
+        samples(&elementPool),
+        gatheredSamples(&frameArena),
+        changedElements(&elementPool),
+        summaryElements(&elementPool),
+        changedSummaries(&elementPool)
+    {
+        static_cast<void>(getPointer(mousePointer));
+    }
 
     InputContext::~InputContext() noexcept = default;
 
@@ -30,185 +222,2045 @@ namespace floah
 
     bool InputContext::getFocus() const noexcept { return focus; }
 
-    math::int2 InputContext::getCursor() const noexcept { return cursor; }
+    math::int2 InputContext::getCursor() const noexcept { return toPixels(pointers.front().submittedCursor); }
+
+    math::int2 InputContext::getCursor(const uint32_t pointer) const noexcept
+    {
+        return toPixels(getPreciseCursor(pointer));
+    }
+
+    math::int2 InputContext::getPreciseCursor(const uint32_t pointer) const noexcept
+    {
+        const auto* p = findPointer(pointer);
+        return p ? p->submittedCursor : math::int2{};
+    }
+
+    InputElement* InputContext::getEnteredElement(const uint32_t pointer) const noexcept
+    {
+        const auto* p = findPointer(pointer);
+        return p ? p->enteredElement : nullptr;
+    }
+
+    InputElement* InputContext::getClaimedElement(const uint32_t pointer) const noexcept
+    {
+        const auto* p = findPointer(pointer);
+        return p ? p->claimedElement : nullptr;
+    }
+
+    size_t InputContext::getEventCapacity() const noexcept { return events.capacity(); }
+
+    InputContext::CoalescePolicy InputContext::getCoalescePolicy() const noexcept { return coalescePolicy; }
+
+    size_t InputContext::getDroppedEventCount() const noexcept
+    {
+        size_t count = droppedEvents;
+        for (const auto& producer : producers) count += producer->getDroppedEventCount();
+        return count;
+    }
+
+    InputContext::HitTestMode InputContext::getHitTestMode() const noexcept { return hitTestMode; }
+
+    bool InputContext::getTransformCacheEnabled() const noexcept { return transformCacheEnabled; }
+
+    bool InputContext::getPropagationEnabled() const noexcept { return propagationEnabled; }
+
+    InputContext::UpdateMode InputContext::getUpdateMode() const noexcept { return updateMode; }
+
+    int32_t InputContext::getHoverCacheRadius() const noexcept { return hoverCacheRadius; }
+
+    InputWorkerPool* InputContext::getWorkerPool() const noexcept { return workerPool; }
+
+    size_t InputContext::getParallelThreshold() const noexcept { return parallelThreshold; }
+
+    int64_t InputContext::getHoverDelay() const noexcept { return hoverDelay; }
+
+    int64_t InputContext::getLongPressDelay() const noexcept { return longPressDelay; }
+
+    int64_t InputContext::getDoubleClickInterval() const noexcept { return doubleClickInterval; }
+
+    int64_t InputContext::getKeyRepeatDelay() const noexcept { return keyRepeatDelay; }
+
+    int64_t InputContext::getKeyRepeatInterval() const noexcept { return keyRepeatInterval; }
+
+    InputElement* InputContext::getFocusedElement() const noexcept { return focusedElement; }
+
+    int32_t InputContext::getTabKey() const noexcept { return tabKey; }
+
+    bool InputContext::getStatsSupported() noexcept { return statsSupported; }
+
+    bool InputContext::getStatsEnabled() const noexcept { return statsEnabled; }
+
+    const InputStats& InputContext::getStats() const noexcept { return stats; }
+
+    const InputContext::FrameSummary& InputContext::getFrameSummary() const noexcept { return frameSummary; }
+
+    std::pmr::memory_resource* InputContext::getMemoryResource() const noexcept { return allocationCounter.upstream; }
+
+    bool InputContext::getAllocationCheck() const noexcept { return allocationCounter.check; }
 
     ////////////////////////////////////////////////////////////////
     // Setters.
     ////////////////////////////////////////////////////////////////
 
-    void InputContext::setTime(const int64_t t) noexcept { time = t; }
+    void InputContext::setTime(const int64_t t) noexcept
+    {
+        time = t;
+        if (recorder) recorder->recordTime(t);
+    }
+
+    void InputContext::setTimestamp(const int64_t ns) noexcept { timestamp = ns; }
+
+    void InputContext::setFocus(const bool f) noexcept
+    {
+        focus = f;
+        if (recorder) recorder->recordFocus(f);
+
+        // Keys held down while the window loses focus are never released.
+        if (!f) timers.cancel(std::exchange(keyRepeatTimer, {}));
+    }
+
+    void InputContext::setEnter(const bool e) noexcept { setEnter(mousePointer, e); }
+
+    void InputContext::setEnter(const uint32_t pointer, const bool e) noexcept
+    {
+        pushEvent(InputEvent{
+          .type = InputEvent::Type::Enter, .time = time, .timestamp = stamp(), .enter = e, .pointer = pointer});
+    }
 
-    void InputContext::setFocus(const bool f) noexcept { focus = f; }
+    void InputContext::setCursor(const math::int2 c) noexcept { setCursor(mousePointer, c); }
+
+    void InputContext::setCursor(const uint32_t pointer, const math::int2 c) noexcept
+    {
+        setPreciseCursor(pointer, toPrecise(c));
+    }
 
-    void InputContext::setEnter(const bool e) noexcept { enter = e; }
+    void InputContext::setPreciseCursor(const math::int2 c) noexcept { setPreciseCursor(mousePointer, c); }
 
-    void InputContext::setCursor(math::int2 c) noexcept { cursor = std::move(c); }
+    void InputContext::setPreciseCursor(const uint32_t pointer, const math::int2 c) noexcept
+    {
+        if (const auto it = std::ranges::find(pointers, pointer, &Pointer::id); it != pointers.end())
+            it->submittedCursor = c;
+        pushEvent(InputEvent{
+          .type = InputEvent::Type::Cursor, .time = time, .timestamp = stamp(), .value = c, .pointer = pointer});
+    }
 
     void InputContext::setMouseButton(const MouseButton    button,
                                       const MouseAction    action,
                                       const MouseModifiers mods) noexcept
     {
-        mouseClick = {button, action, mods};
+        setMouseButton(mousePointer, button, action, mods);
+    }
+
+    void InputContext::setMouseButton(const uint32_t       pointer,
+                                      const MouseButton    button,
+                                      const MouseAction    action,
+                                      const MouseModifiers mods) noexcept
+    {
+        pushEvent(InputEvent{.type      = InputEvent::Type::Button,
+                             .time      = time,
+                             .timestamp = stamp(),
+                             .click     = {.button = button, .action = action, .modifiers = mods, .pointer = pointer},
+                             .pointer   = pointer});
     }
 
     void InputContext::clearMouseButton() noexcept
     {
-        mouseClick  = {};
-        mouseScroll = {};
+        if (recorder) recorder->recordClearButtons();
+        events.removeIf([](const InputEvent& e) {
+            return e.type == InputEvent::Type::Button || e.type == InputEvent::Type::Scroll;
+        });
     }
 
-    void InputContext::setScroll(const math::int2 s) noexcept { mouseScroll = {s}; }
+    void InputContext::setScroll(const math::int2 s) noexcept { setScroll(mousePointer, s); }
 
-    ////////////////////////////////////////////////////////////////
-    // Elements.
-    ////////////////////////////////////////////////////////////////
+    void InputContext::setScroll(const uint32_t pointer, const math::int2 s) noexcept
+    {
+        setPreciseScroll(pointer, toPrecise(s));
+    }
 
-    // TODO: InputElements do not (yet?) store a reference to their context.
-    // They can be added to any number of contexts and will receive events from all of them.
-    // Is this desirable or should it be prevented?
+    void InputContext::setPreciseScroll(const math::int2 s) noexcept { setPreciseScroll(mousePointer, s); }
+
+    void InputContext::setPreciseScroll(const uint32_t pointer, const math::int2 s) noexcept
+    {
+        pushEvent(InputEvent{
+          .type = InputEvent::Type::Scroll, .time = time, .timestamp = stamp(), .value = s, .pointer = pointer});
+    }
+
+    math::int2 InputContext::toPrecise(const math::int2 value) noexcept
+    {
+        const auto scale = [](const int32_t v) {
+            return static_cast<int32_t>(std::clamp<int64_t>(static_cast<int64_t>(v) * subpixelScale,
+                                                            std::numeric_limits<int32_t>::min(),
+                                                            std::numeric_limits<int32_t>::max()));
+        };
+        return math::int2(scale(value.x), scale(value.y));
+    }
+
+    void InputContext::setKey(const int32_t        key,
+                              const int32_t        scancode,
+                              const KeyAction      action,
+                              const MouseModifiers mods) noexcept
+    {
+        pushEvent(InputEvent{
+          .type      = InputEvent::Type::Key,
+          .time      = time,
+          .timestamp = stamp(),
+          .key       = {.key = key, .scancode = scancode, .action = action, .modifiers = mods}});
+    }
+
+    void InputContext::setText(const char32_t codepoint) noexcept
+    {
+        pushEvent(
+          InputEvent{.type = InputEvent::Type::Text, .time = time, .timestamp = stamp(), .codepoint = codepoint});
+    }
 
-    void InputContext::addElement(InputElement& elem) { inputElements.emplace_back(&elem); }
+    void InputContext::setText(const std::u32string_view codepoints) noexcept
+    {
+        for (const auto codepoint : codepoints) setText(codepoint);
+    }
+
+    void InputContext::setText(const std::string_view utf8) noexcept
+    {
+        decodeUtf8(utf8, [this](const char32_t codepoint) { setText(codepoint); });
+    }
+
+    void InputContext::setEventCapacity(const size_t capacity)
+    {
+        eventCapacity = std::max<size_t>(capacity, 1);
+        events.reset(eventCapacity + getProducerCapacity());
+        text.clear();
+        samples.clear();
+    }
 
-    bool InputContext::removeElement(InputElement& elem)
+    void InputContext::setCoalescePolicy(const CoalescePolicy policy) noexcept { coalescePolicy = policy; }
+
+    void InputContext::submitEvent(const InputEvent& event) noexcept
     {
-        if (const auto it = std::ranges::find(inputElements, &elem); it != inputElements.end())
+        auto e        = event;
+        e.timestamp   = e.timestamp != 0 ? e.timestamp : stamp();
+        e.textOffset  = 0;
+        e.textCount   = 0;
+        e.sampleBegin = 0;
+        e.sampleEnd   = 0;
+        if (e.type == InputEvent::Type::Cursor)
         {
-            inputElements.erase(it);
-            return true;
+            if (const auto it = std::ranges::find(pointers, e.pointer, &Pointer::id); it != pointers.end())
+                it->submittedCursor = e.value;
         }
+        pushEvent(e);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Timers.
+    ////////////////////////////////////////////////////////////////
+
+    void InputContext::setHoverDelay(const int64_t delay) noexcept { hoverDelay = std::max<int64_t>(delay, 0); }
+
+    void InputContext::setLongPressDelay(const int64_t delay) noexcept { longPressDelay = std::max<int64_t>(delay, 0); }
+
+    void InputContext::setDoubleClickInterval(const int64_t interval) noexcept
+    {
+        doubleClickInterval = std::max<int64_t>(interval, 0);
+    }
+
+    InputTimerHandle InputContext::scheduleTimer(const InputElement& elem, const int64_t deadline, const uint64_t data)
+    {
+        return scheduleTimer(elementRegistry.find(elem), deadline, data);
+    }
+
+    InputTimerHandle InputContext::scheduleTimer(const InputHandle handle, const int64_t deadline, const uint64_t data)
+    {
+        if (!elementRegistry.get(handle)) return {};
+        return timers.schedule(deadline, Timer{.type = Timer::Type::Element, .element = handle, .data = data});
+    }
 
-        return false;
+    bool InputContext::cancelTimer(const InputTimerHandle timer) noexcept { return timers.cancel(timer); }
+
+    void InputContext::setKeyRepeat(const int64_t delay, const int64_t interval) noexcept
+    {
+        keyRepeatDelay    = std::max<int64_t>(delay, 0);
+        keyRepeatInterval = std::max<int64_t>(interval, 1);
+        if (keyRepeatDelay == 0) timers.cancel(std::exchange(keyRepeatTimer, {}));
     }
 
     ////////////////////////////////////////////////////////////////
-    // Frame.
+    // Focus.
     ////////////////////////////////////////////////////////////////
 
-    void InputContext::prePoll() { clearMouseButton(); }
+    void InputContext::setTabKey(const int32_t key) noexcept { tabKey = key; }
+
+    bool InputContext::focusElement(const InputElement& elem) { return focusElement(elementRegistry.find(elem)); }
 
-    void InputContext::postPoll()
+    bool InputContext::focusElement(const InputHandle handle)
     {
-        // TODO: Only sort when list was updated.
-        // Sort by layer descending.
-        std::ranges::sort(inputElements,
-                          [](const InputElement* lhs, const InputElement* rhs) { return lhs->compare(*rhs); });
+        auto* elem = elementRegistry.get(handle);
+        if (!elem) return false;
+        changeFocus(elem, handle);
+        return true;
+    }
+
+    void InputContext::clearFocusedElement() { changeFocus(nullptr, {}); }
+
+    bool InputContext::focusNext() { return focusNeighbour(true); }
+
+    bool InputContext::focusPrevious() { return focusNeighbour(false); }
 
-        mouseEnterEvents();
-        mouseMoveEvents();
-        mouseClickEvents();
-        mouseScrollEvents();
+    ////////////////////////////////////////////////////////////////
+    // Producers.
+    ////////////////////////////////////////////////////////////////
 
-        previousCursor = cursor;
+    InputProducer& InputContext::addProducer(const size_t capacity)
+    {
+        auto& producer = *producers.emplace_back(std::make_unique<InputProducer>(capacity, &signal));
+        events.reserve(eventCapacity + getProducerCapacity());
+        return producer;
     }
 
-    void InputContext::mouseEnterEvents()
+    ////////////////////////////////////////////////////////////////
+    // Recording.
+    ////////////////////////////////////////////////////////////////
+
+    InputRecorder* InputContext::getRecorder() const noexcept { return recorder; }
+
+    void InputContext::setRecorder(InputRecorder* r) noexcept { recorder = r; }
+
+    void InputContext::setTracer(InputTracer* t) noexcept { tracer = t; }
+
+    ////////////////////////////////////////////////////////////////
+    // Stats.
+    ////////////////////////////////////////////////////////////////
+
+    void InputContext::setStatsEnabled(const bool enabled) noexcept
     {
-        // If mouse is not inside window, exit currently entered element.
-        if (!enter)
-        {
-            if (enteredElement)
-            {
-                constexpr MouseExitEvent e;
-                static_cast<void>(enteredElement->onMouseExit(e));
-                enteredElement = nullptr;
-            }
-            return;
-        }
+        statsEnabled       = statsSupported && enabled;
+        frameStats         = {};
+        statsDroppedEvents = getDroppedEventCount();
+    }
 
-        // Check if currently entered element still contains the cursor position.
-        bool stillInside = false;
-        if (enteredElement)
-        {
-            if (enteredElement->intersect(cursor - enteredElement->getInputOffset()))
-                stillInside = true;
-            else
-            {
-                constexpr MouseExitEvent e;
-                static_cast<void>(enteredElement->onMouseExit(e));
-                enteredElement = nullptr;
-            }
-        }
+    void InputContext::clearStats() noexcept
+    {
+        stats.clear();
+        frameStats = {};
+    }
 
-        // If an element has claimed input, don't try to enter other elements.
-        // But perhaps we need to re-enter the claimed element.
-        if (claimedElement)
-        {
-            if (!enteredElement && claimedElement->intersect(cursor - claimedElement->getInputOffset()))
-            {
-                enteredElement = claimedElement;
-                constexpr MouseEnterEvent e;
-                static_cast<void>(enteredElement->onMouseEnter(e));
-            }
+    ////////////////////////////////////////////////////////////////
+    // Memory.
+    ////////////////////////////////////////////////////////////////
 
-            return;
-        }
+    void InputContext::setAllocationCheck(const bool enabled) noexcept { allocationCounter.check = enabled; }
 
-        // Try to enter new element.
-        for (auto* elem : inputElements)
-        {
-            if (elem == enteredElement) continue;
+    ////////////////////////////////////////////////////////////////
+    // Hit-testing.
+    ////////////////////////////////////////////////////////////////
 
-            // Elements on the same level or below the currently entered element should not take over the entered state.
-            if (stillInside && enteredElement->compare(*elem)) break;
+    void InputContext::setUpdateMode(const UpdateMode mode) noexcept
+    {
+        // The tree is only kept up-to-date in explicit mode, starting from a full update.
+        updateMode = mode;
+        treeDirty  = true;
+        markSceneChanged();
+    }
 
-            if (elem->intersect(cursor - elem->getInputOffset()))
-            {
-                // Exit previous element.
-                if (enteredElement)
-                {
-                    constexpr MouseExitEvent e;
-                    static_cast<void>(enteredElement->onMouseExit(e));
-                }
+    void InputContext::setHitTestMode(const HitTestMode mode) noexcept
+    {
+        hitTestMode = mode;
+        boundsDirty = true;
+        markSceneChanged();
+        boundsBuffer.clear();
+        shapeBuffer.clear();
+        spatialIndex.clear();
+        hierarchy.clear();
+    }
 
-                // Enter new element.
-                enteredElement = elem;
-                constexpr MouseEnterEvent e;
-                static_cast<void>(enteredElement->onMouseEnter(e));
+    void InputContext::setSpatialIndexCellSize(const int32_t size) noexcept
+    {
+        spatialIndex.setCellSize(size);
+        boundsDirty = true;
+        markSceneChanged();
+    }
 
-                break;
-            }
-        }
+    void InputContext::setTransformCacheEnabled(const bool enabled) noexcept
+    {
+        transformCacheEnabled = enabled;
+        treeDirty             = true;
+        boundsDirty           = true;
+        markSceneChanged();
+        transforms.clear();
+    }
+
+    void InputContext::setPropagationEnabled(const bool enabled) noexcept
+    {
+        propagationEnabled = enabled;
+        treeDirty          = true;
+        elementsDirty      = true;
+        propagationPaths.clear();
     }
 
-    void InputContext::mouseMoveEvents()
+    void InputContext::setHoverCacheRadius(const int32_t radius) noexcept
     {
-        if (previousCursor == cursor) return;
+        hoverCacheRadius = std::max(radius, 0);
+        for (auto& pointer : pointers) pointer.hoverWindow.reset();
+    }
 
-        auto* elem = claimedElement;
-        if (!elem && enteredElement) elem = enteredElement;
+    void InputContext::setWorkerPool(InputWorkerPool* pool) noexcept { workerPool = pool; }
 
-        if (elem)
+    void InputContext::setParallelThreshold(const size_t threshold) noexcept { parallelThreshold = threshold; }
+
+    ////////////////////////////////////////////////////////////////
+    // Elements.
+    ////////////////////////////////////////////////////////////////
+
+    // TODO: InputElements do not (yet?) store a reference to their context.
+    // They can be added to any number of contexts and will receive events from all of them.
+    // Is this desirable or should it be prevented?
+
+    InputHandle InputContext::addElement(InputElement& elem)
+    {
+        const auto size   = elementRegistry.size();
+        const auto handle = elementRegistry.add(elem);
+        if (elementRegistry.size() != size)
         {
-            const auto offset = elem->getInputOffset();
-            const auto move   = MouseMoveEvent{.previous = previousCursor - offset, .current = cursor - offset};
-            static_cast<void>(elem->onMouseMove(move));
+            inputElements.add(handle, elem);
+            focusChain.add(handle, elem);
+            if (updateMode == UpdateMode::Explicit && !treeDirty)
+            {
+                tree.insert(elem, handle);
+                if (transformCacheEnabled) transforms.markDirty(elem);
+                hierarchyDirty   = true;
+                propagationDirty = true;
+            }
+            dirtyBounds.emplace_back(&elem);
+            elementsDirty = true;
+            markSceneChanged();
         }
+        return handle;
+    }
+
+    void InputContext::addElements(const std::span<InputElement* const> elems)
+    {
+        reserveElements(elementRegistry.size() + elems.size());
+        for (auto* elem : elems) addElement(*elem);
     }
 
-    void InputContext::mouseClickEvents()
+    void InputContext::reserveElements(const size_t count)
     {
-        if (mouseClick)
+        elementRegistry.reserve(count);
+        inputElements.reserve(count);
+    }
+
+    bool InputContext::removeElement(InputElement& elem) { return removeElement(elementRegistry.find(elem)); }
+
+    bool InputContext::removeElement(const InputHandle handle)
+    {
+        auto* elem = elementRegistry.get(handle);
+        if (!elem) return false;
+
+        // Removed element should not receive any further events.
+        for (auto& pointer : pointers)
         {
-            if (claimedElement)
+            if (pointer.enteredElement == elem)
             {
-                if (!claimedElement->onMouseClick(*mouseClick).claim) claimedElement = nullptr;
+                pointer.enteredElement = nullptr;
+                pointer.enteredHandle  = {};
             }
-            else if (enteredElement)
+            if (pointer.claimedElement == elem)
             {
-                if (enteredElement->onMouseClick(*mouseClick).claim) claimedElement = enteredElement;
+                pointer.claimedElement = nullptr;
+                pointer.claimedHandle  = {};
             }
         }
-    }
 
-    void InputContext::mouseScrollEvents()
-    {
-        if (mouseScroll)
+        if (focusedHandle == handle)
+        {
+            focusedElement = nullptr;
+            focusedHandle  = {};
+        }
+
+        // Element is dropped from the sorted list, focus chain, spatial index and hierarchy on the next update.
+        if (updateMode == UpdateMode::Explicit && !treeDirty)
         {
-            if (claimedElement)
-                static_cast<void>(claimedElement->onMouseScroll(*mouseScroll));
-            else if (enteredElement)
-                static_cast<void>(enteredElement->onMouseScroll(*mouseScroll));
+            tree.erase(*elem);
+            propagationDirty = true;
         }
+        inputElements.remove(handle);
+        focusChain.remove(handle);
+        removedHandles.emplace_back(handle);
+        elementRegistry.remove(handle);
+        elementsDirty = true;
+        markSceneChanged();
+        return true;
+    }
+
+    size_t InputContext::removeElements(const std::span<InputElement* const> elems)
+    {
+        size_t count = 0;
+        for (auto* elem : elems) count += removeElement(*elem) ? 1 : 0;
+        return count;
+    }
+
+    size_t InputContext::removeSubtree(const InputElement& root)
+    {
+        // Sort elements added or invalidated since the last update, so that the paths of all elements are known. The
+        // rest of the update is left to the next poll.
+        updateOrder();
+
+        // Collect handles of root and all its descendants first, because removing elements reorders the registry.
+        subtreeHandles.clear();
+        inputElements.findSubtree(root, subtreeHandles);
+
+        size_t count = 0;
+        for (const auto handle : subtreeHandles) count += removeElement(handle) ? 1 : 0;
+        return count;
+    }
+
+    InputElement* InputContext::getElement(const InputHandle handle) const noexcept
+    {
+        return elementRegistry.get(handle);
+    }
+
+    InputHandle InputContext::findElement(const InputElement& elem) const noexcept
+    {
+        return elementRegistry.find(elem);
     }
 
+    void InputContext::invalidate(const InputElement& elem, const Invalidate what)
+    {
+        const auto has = [what](const Invalidate flag) { return (what & flag) != Invalidate::None; };
+        if (what == Invalidate::None) return;
+        elementsDirty = true;
+        markSceneChanged();
+
+        // Keys of element and descendants are recalculated. If the tree is kept up-to-date, the subtree of the element
+        // is moved to its new parent. Otherwise, the tree is rebuilt, which also recalculates transforms.
+        if (has(Invalidate::Layer) || has(Invalidate::Hierarchy)) inputElements.invalidate(elem);
+        if (has(Invalidate::Hierarchy))
+        {
+            if (updateMode == UpdateMode::Explicit && !treeDirty)
+            {
+                tree.reparent(elem);
+                hierarchyDirty   = true;
+                propagationDirty = true;
+            }
+            else
+                treeDirty = true;
+        }
+
+        // Bounds of all descendants move along with the element.
+        if (has(Invalidate::Hierarchy) || has(Invalidate::Offset))
+        {
+            if (transformCacheEnabled) transforms.markDirty(elem);
+            dirtyOffsets.emplace_back(&elem);
+        }
+
+        // Only the bounds of the element itself changed.
+        if (has(Invalidate::Bounds)) dirtyBounds.emplace_back(&elem);
+
+        // Only the paths are recalculated, the tree is not affected.
+        if (has(Invalidate::Propagation)) propagationDirty = true;
+
+        if (has(Invalidate::Focus))
+        {
+            if (const auto handle = elementRegistry.find(elem); handle.valid()) focusChain.invalidate(handle);
+        }
+    }
+
+    void InputContext::invalidateBounds() noexcept
+    {
+        boundsDirty = true;
+        treeDirty   = true;
+        markSceneChanged();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Queries.
+    ////////////////////////////////////////////////////////////////
+
+    void InputContext::queryElements(const math::int2 point, std::vector<InputHandle>& handles, const size_t limit)
+    {
+        prepareQuery();
+        handles.clear();
+        static_cast<void>(queryPoint(point, limit, candidates, handles));
+    }
+
+    void InputContext::queryElements(const InputBounds& region, std::vector<InputHandle>& handles)
+    {
+        prepareQuery();
+        handles.clear();
+        if (region.empty()) return;
+
+        const auto elements    = inputElements.getElements();
+        const auto elemHandles = inputElements.getHandles();
+        switch (hitTestMode)
+        {
+        case HitTestMode::Linear:
+            for (size_t i = 0; i < elements.size(); i++)
+            {
+                const auto bounds = elements[i]->getInputBounds();
+                if (!bounds ||
+                    bounds->translate(getTransform(*elements[i], elemHandles[i]).offset).overlaps(region))
+                    handles.emplace_back(elemHandles[i]);
+            }
+            break;
+        case HitTestMode::BoundsCulling:
+            for (size_t block = 0; block < boundsBuffer.getBlockCount(); block++)
+            {
+                for (auto mask = boundsBuffer.test(block, region); mask; mask &= mask - 1)
+                    handles.emplace_back(
+                      elemHandles[block * InputBoundsBuffer::blockSize + static_cast<size_t>(std::countr_zero(mask))]);
+            }
+            break;
+        case HitTestMode::SpatialIndex:
+        case HitTestMode::Hierarchy:
+            // Candidates come from the cells or subtrees that overlap the region, so their bounds are tested as well.
+            if (hitTestMode == HitTestMode::SpatialIndex)
+                spatialIndex.query(region, inputElements.getPositions(), candidates, queryBounds);
+            else
+                hierarchy.query(region, inputElements.getPositions(), candidates, queryBounds);
+            for (size_t i = 0; i < candidates.size(); i++)
+                if (queryBounds[i].overlaps(region)) handles.emplace_back(elemHandles[candidates[i]]);
+            break;
+        }
+    }
+
+    void InputContext::queryElements(const std::span<const math::int2> points,
+                                     std::vector<InputHandle>&         handles,
+                                     std::vector<uint32_t>&            pointOffsets,
+                                     const size_t                      limit)
+    {
+        prepareQuery();
+        handles.clear();
+        pointOffsets.clear();
+        pointOffsets.emplace_back(0);
+
+        if (points.size() < 2 || !scanInParallel(points.size() * inputElements.getElements().size()))
+        {
+            for (const auto point : points)
+            {
+                static_cast<void>(queryPoint(point, limit, candidates, handles));
+                pointOffsets.emplace_back(static_cast<uint32_t>(handles.size()));
+            }
+            return;
+        }
+
+        // Each chunk gathers the results of a contiguous range of points, so that concatenating the chunks in order
+        // gives the same result as a single thread.
+        const auto chunkCount = std::min(points.size(), (workerPool->getThreadCount() + 1) * 4);
+        const auto chunkSize  = (points.size() + chunkCount - 1) / chunkCount;
+        // Chunks are filled by the worker threads, so they allocate from the thread-safe resource instead of the pool.
+        while (queryChunks.size() < chunkCount)
+        {
+            queryChunks.emplace_back(QueryChunk{.handles    = std::pmr::vector<InputHandle>(&allocationCounter),
+                                                .counts     = std::pmr::vector<uint32_t>(&allocationCounter),
+                                                .candidates = std::pmr::vector<uint32_t>(&allocationCounter)});
+        }
+
+        workerPool->run(chunkCount, [&](const size_t c) {
+            auto& chunk = queryChunks[c];
+            chunk.handles.clear();
+            chunk.counts.clear();
+            const auto end = std::min(points.size(), (c + 1) * chunkSize);
+            for (auto i = c * chunkSize; i < end; i++)
+                chunk.counts.emplace_back(
+                  static_cast<uint32_t>(queryPoint(points[i], limit, chunk.candidates, chunk.handles)));
+        });
+
+        for (size_t c = 0; c < chunkCount; c++)
+        {
+            const auto& chunk = queryChunks[c];
+            handles.insert(handles.end(), chunk.handles.begin(), chunk.handles.end());
+            for (const auto count : chunk.counts) pointOffsets.emplace_back(pointOffsets.back() + count);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Frame.
+    ////////////////////////////////////////////////////////////////
+
+    void InputContext::prePoll()
+    {
+        allocationCounter.active = true;
+
+        // Queued events are drained by postPoll, so only the scratch space of the previous frame is cleared.
+        resetArena(frameArena,
+                   propagationPath,
+                   offsets,
+                   candidates,
+                   scanningPointers,
+                   traceEvents,
+                   queryBounds,
+                   subtreeHandles,
+                   expiredTimers,
+                   gatheredSamples);
+        if (recorder) recorder->recordPrePoll();
+
+        allocationCounter.active = false;
+    }
+
+    const InputContext::FrameSummary& InputContext::postPoll()
+    {
+        const auto frameStart    = tracer ? steadyNow() : 0;
+        allocationCounter.active = true;
+
+        // Changes made by event handlers during this poll are picked up by the next one.
+        const auto changed = std::exchange(sceneChanged, false);
+
+        updateElements();
+
+        // Move events submitted by other threads into the queue.
+        InputEvent event;
+        for (const auto& producer : producers)
+            while (producer->pop(event)) pushEvent(event);
+        if (recorder) recorder->recordPostPoll();
+
+        // Dispatch queued events in order. Pointers that moved are resolved together, before the first event that
+        // depends on one of them. Events of a pointer that is still pending are dispatched after resolving it.
+        for (auto& pointer : pointers) pointer.resolved = false;
+        while (events.pop(event))
+        {
+            // Timers that expire before the event see the state of all pointers up to that point.
+            if (timers.getNextExpiration() <= event.time)
+            {
+                resolvePointers();
+                fireTimers(event.time);
+            }
+
+            auto& pointer = getPointer(event.pointer);
+            switch (event.type)
+            {
+            case InputEvent::Type::Cursor:
+                if (pointer.moved) resolvePointers();
+                pointer.submittedCursor = event.value;
+                pointer.preciseCursor   = event.value;
+                pointer.cursor          = toPixels(event.value);
+                pointer.sampleBegin     = event.sampleBegin;
+                pointer.sampleEnd       = event.sampleEnd;
+                pointer.pending         = true;
+                pointer.moved           = true;
+                pointer.resolved        = true;
+                pointer.time            = event.time;
+                pointer.cursorTimestamp = event.timestamp;
+                break;
+            case InputEvent::Type::Enter:
+                // The window system reports entering before the position, which must not be resolved on its own.
+                pointer.enter          = event.enter;
+                pointer.pending        = true;
+                pointer.resolved       = true;
+                pointer.time           = event.time;
+                pointer.enterTimestamp = event.timestamp;
+                break;
+            case InputEvent::Type::Button:
+                if (pointer.pending || !pointer.resolved)
+                {
+                    pointer.pending  = true;
+                    pointer.resolved = true;
+                    pointer.time     = event.time;
+                    resolvePointers();
+                }
+                {
+                    const auto start = traceLatency() ? steadyNow() : 0;
+                    mouseClickEvents(pointer, event.click, event.time);
+                    traceEvent(InputLatency::Click, event.pointer, event.timestamp, start);
+                }
+                break;
+            case InputEvent::Type::Scroll:
+                if (pointer.pending || !pointer.resolved)
+                {
+                    pointer.pending  = true;
+                    pointer.resolved = true;
+                    pointer.time     = event.time;
+                    resolvePointers();
+                }
+                {
+                    const auto start = traceLatency() ? steadyNow() : 0;
+                    mouseScrollEvents(pointer, event);
+                    traceEvent(InputLatency::Scroll, event.pointer, event.timestamp, start);
+                }
+                break;
+            case InputEvent::Type::Key:
+            {
+                const auto start = traceLatency() ? steadyNow() : 0;
+                keyEvents(event.key, event.time);
+                traceEvent(InputLatency::Key, mousePointer, event.timestamp, start);
+                break;
+            }
+            case InputEvent::Type::Text:
+            {
+                const auto start = traceLatency() ? steadyNow() : 0;
+                textEvents(std::span(text).subspan(event.textOffset, event.textCount));
+                traceEvent(InputLatency::Text, mousePointer, event.timestamp, start);
+                break;
+            }
+            }
+        }
+        text.clear();
+
+        // Elements can have moved under a pointer even if it did not move itself.
+        for (auto& pointer : pointers)
+        {
+            if (pointer.resolved || (!changed && updateMode != UpdateMode::Poll)) continue;
+            pointer.pending = true;
+            pointer.time    = time;
+        }
+        resolvePointers();
+        samples.clear();
+        if (timers.getNextExpiration() <= time) fireTimers(time);
+
+        if (collectStats()) recordStats();
+        publishSummary();
+
+        if (tracer)
+        {
+            tracer->traceFrame(InputFrameTrace{.frame            = summaryIndex - 1,
+                                               .start            = frameStart,
+                                               .end              = steadyNow(),
+                                               .dispatchedEvents = frameSummary.dispatchedEvents,
+                                               .events           = traceEvents});
+        }
+        traceEvents.clear();
+        allocationCounter.active = false;
+        return frameSummary;
+    }
+
+    bool InputContext::waitForInput(const std::chrono::nanoseconds timeout)
+    {
+        // Read the signal first, so that events submitted while checking are not missed.
+        const auto seen = signal.get();
+        if (!events.empty() || sceneChanged || timers.getNextExpiration() <= time) return true;
+        if (std::ranges::any_of(producers, [](const auto& producer) { return !producer->empty(); })) return true;
+        return signal.wait(seen, timeout);
+    }
+
+    void InputContext::wake() noexcept { signal.notify(); }
+
+    void InputContext::updateElements()
+    {
+        const ScopedTimer timer(collectStats(), frameStats[InputMetric::SortTime]);
+
+        // Sort by layer descending. Only does work if elements were added or removed, or their layers changed.
+        updateOrder();
+        elementsDirty = false;
+
+        // Clicked elements are looked up in the focus chain.
+        focusChain.update(elementRegistry);
+
+        // The tree is needed to find the descendants of invalidated elements, by the hierarchy, to propagate transforms
+        // to descendants and to propagate events to ancestors.
+        if (updateMode == UpdateMode::Explicit || hitTestMode != HitTestMode::Linear || transformCacheEnabled ||
+            propagationEnabled)
+        {
+            if (treeDirty)
+            {
+                tree.build(inputElements.getElements(), inputElements.getHandles());
+                if (transformCacheEnabled) transforms.build(tree, elementRegistry.getSlotCount());
+                treeDirty        = false;
+                boundsDirty      = true;
+                propagationDirty = true;
+            }
+            else if (transformCacheEnabled)
+                static_cast<void>(transforms.refresh(tree));
+
+            if (propagationEnabled && propagationDirty) propagationPaths.build(tree, elementRegistry.getSlotCount());
+        }
+        propagationDirty = false;
+
+        if (boundsDirty)
+            rebuildBounds();
+        else
+            updateBounds();
+        boundsDirty      = false;
+        hierarchyDirty   = false;
+        changedPositions = {};
+        dirtyBounds.clear();
+        dirtyOffsets.clear();
+        removedHandles.clear();
+    }
+
+    void InputContext::updateOrder()
+    {
+        const auto full = updateMode == UpdateMode::Poll || treeDirty;
+        if (!inputElements.update(elementRegistry, tree, full)) return;
+
+        if (full)
+        {
+            treeDirty   = true;
+            boundsDirty = true;
+            return;
+        }
+
+        // Positions outside of both ranges hold the same element as before either update.
+        const auto range = inputElements.getChanged();
+        if (changedPositions.begin == changedPositions.end)
+            changedPositions = range;
+        else
+        {
+            changedPositions.begin = std::min(changedPositions.begin, range.begin);
+            changedPositions.end   = std::max(changedPositions.end, range.end);
+        }
+    }
+
+    void InputContext::gatherOffsets()
+    {
+        const auto elements = inputElements.getElements();
+        const auto handles  = inputElements.getHandles();
+        offsets.resize(elements.size());
+        for (size_t i = 0; i < elements.size(); i++) offsets[i] = getTransform(*elements[i], handles[i]).offset;
+    }
+
+    void InputContext::rebuildBounds()
+    {
+        if (hitTestMode == HitTestMode::Linear) return;
+
+        const auto elements = inputElements.getElements();
+        gatherOffsets();
+        switch (hitTestMode)
+        {
+        case HitTestMode::Linear: break;
+        case HitTestMode::BoundsCulling: boundsBuffer.build(elements, offsets); break;
+        case HitTestMode::SpatialIndex: spatialIndex.build(elements, inputElements.getHandles(), offsets); break;
+        case HitTestMode::Hierarchy: hierarchy.build(tree, inputElements.getPositions(), offsets); break;
+        }
+        shapeBuffer.build(elements, offsets);
+        for (auto& pointer : pointers) pointer.hoverWindow.reset();
+    }
+
+    void InputContext::updateBounds()
+    {
+        if (hitTestMode == HitTestMode::Linear) return;
+        if (changedPositions.begin == changedPositions.end && removedHandles.empty() && dirtyBounds.empty() &&
+            dirtyOffsets.empty())
+            return;
+
+        const auto elements = inputElements.getElements();
+        const auto handles  = inputElements.getHandles();
+        const auto nodes    = tree.getNodes();
+
+        // Elements that moved in the sorted list are stored at their new position in the buffers. The spatial index
+        // and hierarchy refer to elements by handle, so moving them does not affect those.
+        if (hitTestMode == HitTestMode::BoundsCulling) boundsBuffer.resize(elements.size());
+        shapeBuffer.resize(elements.size());
+        const auto end = std::min<size_t>(changedPositions.end, elements.size());
+        for (size_t i = changedPositions.begin; i < end; i++)
+        {
+            const auto offset = getTransform(*elements[i], handles[i]).offset;
+            if (hitTestMode == HitTestMode::BoundsCulling) boundsBuffer.update(i, *elements[i], offset);
+            shapeBuffer.update(i, *elements[i], offset);
+        }
+
+        for (const auto handle : removedHandles)
+        {
+            if (hitTestMode == HitTestMode::SpatialIndex) spatialIndex.remove(handle);
+            if (hitTestMode == HitTestMode::Hierarchy) hierarchy.remove(handle);
+        }
+
+        // Recalculate the bounds of a single node. Ancestors that were not added can still clip their children.
+        const auto update = [&](const uint32_t n) {
+            const auto& node   = nodes[n];
+            const auto  pos    = inputElements.getPosition(node.handle);
+            const auto  offset = pos == InputHandle::invalidIndex ? node.element->getInputOffset() :
+                                                                    getTransform(*node.element, node.handle).offset;
+            if (hitTestMode == HitTestMode::Hierarchy && !hierarchyDirty)
+                hierarchyDirty = !hierarchy.update(tree, n, offset);
+            if (pos == InputHandle::invalidIndex) return;
+
+            if (hitTestMode == HitTestMode::BoundsCulling) boundsBuffer.update(pos, *node.element, offset);
+            if (hitTestMode == HitTestMode::SpatialIndex) spatialIndex.update(node.handle, *node.element, offset);
+            shapeBuffer.update(pos, *node.element, offset);
+        };
+
+        // Elements whose offset changed are updated along with their descendants.
+        for (const auto* elem : dirtyOffsets)
+        {
+            const auto root = tree.find(*elem);
+            for (auto n = root; n != InputTree::none; n = tree.getNext(n, root)) update(n);
+        }
+        for (const auto* elem : dirtyBounds)
+            if (const auto n = tree.find(*elem); n != InputTree::none) update(n);
+
+        // Elements were added or reparented, or an element started or stopped clipping its children.
+        if (hitTestMode == HitTestMode::Hierarchy && hierarchyDirty)
+        {
+            gatherOffsets();
+            hierarchy.build(tree, inputElements.getPositions(), offsets);
+        }
+
+        // Bounds that moved out of the grid end up in its border cells, which fills them up over time.
+        if (hitTestMode == HitTestMode::SpatialIndex && spatialIndex.isStale())
+        {
+            gatherOffsets();
+            spatialIndex.build(elements, handles, offsets);
+        }
+
+        // Hover candidates are positions, which can have changed as well.
+        for (auto& pointer : pointers) pointer.hoverWindow.reset();
+    }
+
+    InputContext::Pointer& InputContext::getPointer(const uint32_t id)
+    {
+        for (auto& pointer : pointers)
+            if (pointer.id == id) return pointer;
+        return pointers.emplace_back(Pointer{.id                   = id,
+                                             .hoverCandidates      = std::pmr::vector<uint32_t>(&elementPool),
+                                             .hoverCandidateBounds = std::pmr::vector<InputBounds>(&elementPool)});
+    }
+
+    const InputContext::Pointer* InputContext::findPointer(const uint32_t id) const noexcept
+    {
+        const auto it = std::ranges::find(pointers, id, &Pointer::id);
+        return it != pointers.end() ? &*it : nullptr;
+    }
+
+    void InputContext::markSceneChanged() noexcept
+    {
+        sceneChanged = true;
+        for (auto& pointer : pointers) pointer.hoverResolved = false;
+    }
+
+    void InputContext::updateHoverWindow(Pointer& pointer)
+    {
+        const auto clamp = [](const int64_t v) {
+            return static_cast<int32_t>(std::clamp<int64_t>(v, std::numeric_limits<int32_t>::min(),
+                                                            std::numeric_limits<int32_t>::max()));
+        };
+        const auto window =
+          InputBounds{.lower = math::int2(clamp(static_cast<int64_t>(pointer.cursor.x) - hoverCacheRadius),
+                                          clamp(static_cast<int64_t>(pointer.cursor.y) - hoverCacheRadius)),
+                      .upper = math::int2(clamp(static_cast<int64_t>(pointer.cursor.x) + hoverCacheRadius + 1),
+                                          clamp(static_cast<int64_t>(pointer.cursor.y) + hoverCacheRadius + 1))};
+        pointer.hoverWindow = window;
+
+        switch (hitTestMode)
+        {
+        case HitTestMode::Linear:
+            pointer.hoverCandidates.clear();
+            pointer.hoverCandidateBounds.clear();
+            break;
+        case HitTestMode::BoundsCulling:
+            pointer.hoverCandidates.clear();
+            pointer.hoverCandidateBounds.clear();
+            for (size_t block = 0; block < boundsBuffer.getBlockCount(); block++)
+            {
+                for (auto mask = boundsBuffer.test(block, window); mask; mask &= mask - 1)
+                {
+                    const auto i = block * InputBoundsBuffer::blockSize + static_cast<size_t>(std::countr_zero(mask));
+                    pointer.hoverCandidates.emplace_back(static_cast<uint32_t>(i));
+                    pointer.hoverCandidateBounds.emplace_back(boundsBuffer.getBounds(i));
+                }
+            }
+            break;
+        case HitTestMode::SpatialIndex:
+            spatialIndex.query(
+              window, inputElements.getPositions(), pointer.hoverCandidates, pointer.hoverCandidateBounds);
+            break;
+        case HitTestMode::Hierarchy:
+            hierarchy.query(
+              window, inputElements.getPositions(), pointer.hoverCandidates, pointer.hoverCandidateBounds);
+            break;
+        }
+    }
+
+    InputTransform InputContext::getTransform(const InputElement& elem, const InputHandle handle) const noexcept
+    {
+        if (transformCacheEnabled) return transforms.get(elem, handle);
+        return InputTransform{.offset = elem.getInputOffset()};
+    }
+
+    bool InputContext::collectStats() const noexcept { return statsSupported && statsEnabled; }
+
+    void InputContext::addStat(const InputMetric metric, const uint64_t value) noexcept
+    {
+        if (collectStats()) frameStats[metric] += value;
+    }
+
+    void InputContext::recordStats() noexcept
+    {
+        const auto dropped                     = getDroppedEventCount();
+        frameStats[InputMetric::DroppedEvents] = dropped - statsDroppedEvents;
+        statsDroppedEvents                     = dropped;
+        stats.record(frameStats);
+        frameStats = {};
+    }
+
+    bool InputContext::traceLatency() const noexcept { return collectStats() || tracer; }
+
+    int64_t InputContext::stamp() const noexcept
+    {
+        if (timestamp != 0) return timestamp;
+        return traceLatency() ? steadyNow() : 0;
+    }
+
+    void InputContext::traceEvent(const InputLatency type,
+                                  const uint32_t     pointer,
+                                  const int64_t      source,
+                                  const int64_t      start)
+    {
+        if (source == 0 || !traceLatency()) return;
+
+        // Timestamps from another clock can be in the future.
+        if (collectStats()) stats.recordLatency(type, static_cast<uint64_t>(std::max<int64_t>(start - source, 0)));
+        if (tracer)
+        {
+            traceEvents.emplace_back(InputEventTrace{
+              .type = type, .pointer = pointer, .timestamp = source, .start = start, .end = steadyNow()});
+        }
+    }
+
+    void InputContext::countDispatched(const uint64_t count) noexcept
+    {
+        dispatchedEvents += count;
+        addStat(InputMetric::DispatchedEvents, count);
+    }
+
+    void InputContext::markChanged(const InputElement& elem, const InputHandle handle)
+    {
+        if (handle.index >= changedSummaries.size()) changedSummaries.resize(elementRegistry.getSlotCount());
+        if (std::exchange(changedSummaries[handle.index], summaryIndex) == summaryIndex) return;
+        changedElements.emplace_back(handle);
+
+        const auto bounds = elem.getInputBounds();
+        if (!bounds)
+        {
+            unboundedDamage = true;
+            return;
+        }
+        const auto global = bounds->translate(getTransform(elem, handle).offset);
+        damage            = damage ? damage->merge(global) : global;
+    }
+
+    void InputContext::publishSummary()
+    {
+        // Elements can have been removed after they changed.
+        std::erase_if(changedElements, [this](const InputHandle handle) { return !elementRegistry.contains(handle); });
+        std::swap(summaryElements, changedElements);
+        changedElements.clear();
+
+        frameSummary = FrameSummary{.dispatchedEvents = std::exchange(dispatchedEvents, 0),
+                                    .changedElements  = summaryElements,
+                                    .damage           = std::exchange(damage, std::nullopt),
+                                    .unboundedDamage  = std::exchange(unboundedDamage, false),
+                                    .nextTimer        = timers.getNextExpiration(),
+                                    .allocations      = allocationCounter.allocations.exchange(0)};
+        summaryIndex++;
+    }
+
+    void InputContext::pushEvent(const InputEvent& event) noexcept
+    {
+        if (recorder) recorder->recordEvent(event);
+
+        // Text is merged into the last queued event if that is text as well, so that a burst of text is dispatched at
+        // once.
+        if (event.type == InputEvent::Type::Text)
+        {
+            text.emplace_back(event.codepoint);
+            if (!events.empty() && events.back().type == InputEvent::Type::Text)
+            {
+                events.back().time = event.time;
+                events.back().textCount++;
+                if (events.back().timestamp == 0) events.back().timestamp = event.timestamp;
+                return;
+            }
+
+            auto e       = event;
+            e.textOffset = static_cast<uint32_t>(text.size() - 1);
+            e.textCount  = 1;
+            if (events.push(e)) return;
+            text.pop_back();
+            droppedEvents++;
+            return;
+        }
+
+        const auto motion = [](const InputEvent::Type type) {
+            return type == InputEvent::Type::Cursor || type == InputEvent::Type::Scroll;
+        };
+        if (!motion(event.type))
+        {
+            if (!events.push(event)) droppedEvents++;
+            return;
+        }
+
+        auto e = event;
+        if (coalescePolicy.history)
+        {
+            e.sampleBegin = static_cast<uint32_t>(samples.size());
+            e.sampleEnd   = e.sampleBegin + 1;
+            samples.emplace_back(Sample{.sample  = {.time = e.time, .timestamp = e.timestamp, .value = e.value},
+                                        .type    = e.type,
+                                        .pointer = e.pointer});
+        }
+
+        // Merge with the last queued event of the same type and pointer, looking past cursor and scroll events of
+        // other types and pointers if the policy allows it. When the queue is full, events are always merged, because
+        // dropping them would be worse than losing intermediate positions.
+        if (events.full() || (e.type == InputEvent::Type::Cursor ? coalescePolicy.cursor : coalescePolicy.scroll))
+        {
+            for (auto i = events.size(); i-- > 0;)
+            {
+                auto& queued = events[i];
+                if (queued.type == e.type && queued.pointer == e.pointer)
+                {
+                    // The latency of merged events is that of the oldest one.
+                    if (queued.timestamp == 0) queued.timestamp = e.timestamp;
+                    queued.time      = e.time;
+                    queued.value     = e.type == InputEvent::Type::Cursor ? e.value : queued.value + e.value;
+                    queued.sampleEnd = e.sampleEnd;
+                    return;
+                }
+                if (!coalescePolicy.interleaved || !motion(queued.type)) break;
+            }
+        }
+
+        if (events.push(e)) return;
+        if (coalescePolicy.history) samples.pop_back();
+        droppedEvents++;
+    }
+
+    size_t InputContext::getProducerCapacity() const noexcept
+    {
+        size_t capacity = 0;
+        for (const auto& producer : producers) capacity += producer->getCapacity();
+        return capacity;
+    }
+
+    std::span<const InputContext::InputSample> InputContext::gatherSamples(const InputEvent::Type type,
+                                                                           const uint32_t         pointer,
+                                                                           const uint32_t         begin,
+                                                                           const uint32_t         end,
+                                                                           const math::int2       offset)
+    {
+        gatheredSamples.clear();
+        for (auto i = begin; i < end && i < samples.size(); i++)
+        {
+            const auto& sample = samples[i];
+            if (sample.type != type || sample.pointer != pointer) continue;
+            auto& gathered = gatheredSamples.emplace_back(sample.sample);
+            gathered.value = gathered.value - offset;
+        }
+        return gatheredSamples;
+    }
+
+    void InputContext::resolvePointers()
+    {
+        const auto start    = traceLatency() ? steadyNow() : 0;
+        const auto sortTime = frameStats[InputMetric::SortTime];
+        scanningPointers.clear();
+        bool any = false;
+        {
+            const ScopedTimer timer(collectStats(), frameStats[InputMetric::EnterTime]);
+
+            for (size_t i = 0; i < pointers.size(); i++)
+            {
+                if (!pointers[i].pending) continue;
+                any = true;
+                if (prepareHover(pointers[i])) scanningPointers.emplace_back(i);
+            }
+
+            if (!scanningPointers.empty())
+            {
+                // Event handlers called while preparing can have added or removed elements.
+                if (elementsDirty) updateElements();
+                for (const auto i : scanningPointers)
+                {
+                    auto& pointer           = pointers[i];
+                    pointer.enteredPosition = pointer.stillInside ? inputElements.getPosition(pointer.enteredHandle) :
+                                                                    InputHandle::invalidIndex;
+                }
+                scanHover();
+
+                for (const auto i : scanningPointers)
+                {
+                    auto& pointer    = pointers[i];
+                    pointer.scanning = false;
+                    if (!pointer.target) continue;
+
+                    // Target can have been removed by an event handler of another pointer.
+                    if (elementRegistry.get(pointer.targetHandle) != pointer.target) continue;
+
+                    // Exit previous element.
+                    if (pointer.enteredElement)
+                    {
+                        markChanged(*pointer.enteredElement, pointer.enteredHandle);
+                        static_cast<void>(pointer.enteredElement->onMouseExit(MouseExitEvent{.pointer = pointer.id}));
+                        countDispatched();
+                    }
+
+                    // Enter new element.
+                    pointer.enteredElement = pointer.target;
+                    pointer.enteredHandle  = pointer.targetHandle;
+                    const auto transform = getTransform(*pointer.enteredElement, pointer.enteredHandle);
+                    const auto enter =
+                      MouseEnterEvent{.pointer = pointer.id, .position = transform.toLocal(pointer.cursor)};
+                    markChanged(*pointer.enteredElement, pointer.enteredHandle);
+                    static_cast<void>(pointer.enteredElement->onMouseEnter(enter));
+                    countDispatched();
+                }
+            }
+        }
+        // Elements sorted while resolving are only counted as SortTime.
+        frameStats[InputMetric::EnterTime] -= frameStats[InputMetric::SortTime] - sortTime;
+        if (!any) return;
+
+        for (auto& pointer : pointers)
+        {
+            if (!pointer.pending) continue;
+            pointer.pending = false;
+            pointer.moved   = false;
+
+            // Remember the outcome, so that it can be reused if nothing changes.
+            pointer.hoverCursor  = pointer.cursor;
+            pointer.hoverEntered = pointer.enteredHandle;
+            pointer.hoverClaimed = pointer.claimedHandle;
+
+            updatePointerTimers(pointer);
+            mouseMoveEvents(pointer);
+            pointer.previousCursor        = pointer.cursor;
+            pointer.previousPreciseCursor = pointer.preciseCursor;
+            pointer.sampleBegin           = 0;
+            pointer.sampleEnd             = 0;
+
+            traceEvent(InputLatency::Enter, pointer.id, std::exchange(pointer.enterTimestamp, 0), start);
+            traceEvent(InputLatency::Move, pointer.id, std::exchange(pointer.cursorTimestamp, 0), start);
+        }
+    }
+
+    bool InputContext::prepareHover(Pointer& pointer)
+    {
+        // Nothing that could change the outcome happened since the last resolution.
+        if (pointer.hoverResolved && pointer.enter && !elementsDirty && pointer.cursor == pointer.hoverCursor &&
+            pointer.enteredHandle == pointer.hoverEntered && pointer.claimedHandle == pointer.hoverClaimed)
+        {
+            addStat(InputMetric::HoverReuses);
+            return false;
+        }
+
+        // Event handlers that change the scene during resolution clear the flag again.
+        pointer.hoverResolved = updateMode == UpdateMode::Explicit;
+
+        // If pointer is not inside window, exit currently entered element.
+        if (!pointer.enter)
+        {
+            if (pointer.enteredElement)
+            {
+                markChanged(*pointer.enteredElement, pointer.enteredHandle);
+                static_cast<void>(pointer.enteredElement->onMouseExit(MouseExitEvent{.pointer = pointer.id}));
+                countDispatched();
+                pointer.enteredElement = nullptr;
+                pointer.enteredHandle  = {};
+            }
+            return false;
+        }
+
+        // Elements were added or removed by an event handler earlier during this poll.
+        if (elementsDirty) updateElements();
+
+        // Check if currently entered element still contains the cursor position.
+        pointer.stillInside = false;
+        if (pointer.enteredElement)
+        {
+            addStat(InputMetric::IntersectCalls);
+            const auto transform = getTransform(*pointer.enteredElement, pointer.enteredHandle);
+            if (pointer.enteredElement->intersect(transform.toLocal(pointer.cursor)))
+                pointer.stillInside = true;
+            else
+            {
+                markChanged(*pointer.enteredElement, pointer.enteredHandle);
+                static_cast<void>(pointer.enteredElement->onMouseExit(MouseExitEvent{.pointer = pointer.id}));
+                countDispatched();
+                pointer.enteredElement = nullptr;
+                pointer.enteredHandle  = {};
+            }
+        }
+
+        // If an element has claimed input, don't try to enter other elements.
+        // But perhaps we need to re-enter the claimed element.
+        if (pointer.claimedElement)
+        {
+            if (!pointer.enteredElement)
+            {
+                addStat(InputMetric::IntersectCalls);
+                const auto position =
+                  getTransform(*pointer.claimedElement, pointer.claimedHandle).toLocal(pointer.cursor);
+                if (pointer.claimedElement->intersect(position))
+                {
+                    pointer.enteredElement = pointer.claimedElement;
+                    pointer.enteredHandle  = pointer.claimedHandle;
+                    markChanged(*pointer.enteredElement, pointer.enteredHandle);
+                    static_cast<void>(pointer.enteredElement->onMouseEnter(
+                      MouseEnterEvent{.pointer = pointer.id, .position = position}));
+                    countDispatched();
+                }
+            }
+
+            return false;
+        }
+
+        pointer.scanning     = true;
+        pointer.target       = nullptr;
+        pointer.targetHandle = {};
+        return true;
+    }
+
+    void InputContext::scanHover()
+    {
+        const auto elements = inputElements.getElements();
+
+        // Pointers that use the hover window or a spatial query are cheap to resolve on their own.
+        if (hitTestMode != HitTestMode::Linear && hoverCacheRadius > 0)
+        {
+            // Test the elements gathered for the window around a previous cursor position, as long as the cursor
+            // stays inside of it. Bounds are tested first, which gives the same candidates as a query of the whole
+            // structure.
+            for (const auto p : scanningPointers)
+            {
+                auto& pointer = pointers[p];
+                if (!pointer.hoverWindow || !pointer.hoverWindow->contains(pointer.cursor)) updateHoverWindow(pointer);
+                const auto visit = [&pointer](const size_t i, const auto& test) {
+                    if (pointer.hoverCandidateBounds[i].contains(pointer.cursor))
+                        static_cast<void>(test(pointer.hoverCandidates[i]));
+                };
+                if (scanInParallel(pointer.hoverCandidates.size()))
+                {
+                    scanParallel(pointer, pointer.hoverCandidates.size(), visit);
+                    continue;
+                }
+                for (size_t i = 0; i < pointer.hoverCandidates.size(); i++)
+                {
+                    if (!pointer.hoverCandidateBounds[i].contains(pointer.cursor)) continue;
+                    if (scanElement(pointer, pointer.hoverCandidates[i])) break;
+                }
+            }
+            return;
+        }
+
+        switch (hitTestMode)
+        {
+        case HitTestMode::Linear:
+        {
+            if (scanInParallel(elements.size()))
+            {
+                for (const auto p : scanningPointers)
+                    scanParallel(pointers[p], elements.size(), [](const size_t i, const auto& test) {
+                        static_cast<void>(test(i));
+                    });
+                break;
+            }
+
+            // Single pass over all elements, testing each element against all pointers that are not finished yet.
+            auto remaining = scanningPointers.size();
+            for (size_t i = 0; i < elements.size() && remaining > 0; i++)
+            {
+                for (const auto p : scanningPointers)
+                {
+                    auto& pointer = pointers[p];
+                    if (!pointer.scanning) continue;
+                    if (!scanElement(pointer, i)) continue;
+                    pointer.scanning = false;
+                    remaining--;
+                }
+            }
+            break;
+        }
+        case HitTestMode::BoundsCulling:
+        {
+            if (scanInParallel(elements.size()))
+            {
+                for (const auto p : scanningPointers)
+                {
+                    const auto cursor = pointers[p].cursor;
+                    const auto blocks = scannedBlocks(pointers[p]);
+                    scanParallel(pointers[p], blocks, [this, cursor](const size_t block, const auto& test) {
+                        for (auto mask = shapeBuffer.test(block, cursor); mask; mask &= mask - 1)
+                        {
+                            if (test(block * InputShapeBuffer::blockSize + static_cast<size_t>(std::countr_zero(mask))))
+                                break;
+                        }
+                    });
+                }
+                break;
+            }
+
+            // Test bounds and shapes of a block of elements at once against each pointer and only test elements that
+            // might contain that pointer.
+            auto remaining = scanningPointers.size();
+            for (size_t block = 0; block < shapeBuffer.getBlockCount() && remaining > 0; block++)
+            {
+                for (const auto p : scanningPointers)
+                {
+                    auto& pointer = pointers[p];
+                    if (!pointer.scanning) continue;
+
+                    // The bounds filter can reject all elements that would stop the scan, so blocks past the entered
+                    // element are not tested at all.
+                    if (block >= scannedBlocks(pointer))
+                    {
+                        pointer.scanning = false;
+                        remaining--;
+                        continue;
+                    }
+
+                    for (auto mask = shapeBuffer.test(block, pointer.cursor); mask; mask &= mask - 1)
+                    {
+                        const auto i =
+                          block * InputShapeBuffer::blockSize + static_cast<size_t>(std::countr_zero(mask));
+                        if (!scanElement(pointer, i)) continue;
+                        pointer.scanning = false;
+                        remaining--;
+                        break;
+                    }
+                }
+            }
+            break;
+        }
+        case HitTestMode::SpatialIndex:
+        case HitTestMode::Hierarchy:
+            // Only test elements whose bounds contain the cursor (and, for the hierarchy, that are not clipped by an
+            // ancestor).
+            for (const auto p : scanningPointers)
+            {
+                auto& pointer = pointers[p];
+                if (hitTestMode == HitTestMode::SpatialIndex)
+                    spatialIndex.query(pointer.cursor, inputElements.getPositions(), candidates);
+                else
+                    hierarchy.query(pointer.cursor, inputElements.getPositions(), candidates);
+
+                if (scanInParallel(candidates.size()))
+                {
+                    scanParallel(pointer, candidates.size(), [this](const size_t i, const auto& test) {
+                        static_cast<void>(test(candidates[i]));
+                    });
+                    continue;
+                }
+                for (const auto i : candidates)
+                    if (scanElement(pointer, i)) break;
+            }
+            break;
+        }
+    }
+
+    bool InputContext::scanElement(Pointer& pointer, const size_t index)
+    {
+        const auto outcome = testElement(pointer, index);
+        addScanStats(pointer, index, outcome);
+        if (outcome == ScanOutcome::Hit)
+        {
+            pointer.target       = inputElements.getElements()[index];
+            pointer.targetHandle = inputElements.getHandles()[index];
+        }
+        return outcome == ScanOutcome::Stop || outcome == ScanOutcome::Hit;
+    }
+
+    InputContext::ScanOutcome InputContext::testElement(const Pointer& pointer, const size_t index) const noexcept
+    {
+        const auto* elem = inputElements.getElements()[index];
+        if (elem == pointer.enteredElement) return ScanOutcome::Skip;
+
+        // Elements on the same level or below the currently entered element should not take over the entered state.
+        // The sorted position decides rather than InputElement::compare, which ties across subtrees on equal layers,
+        // so that the outcome does not depend on which elements a hit-test mode visits.
+        if (pointer.stillInside && index > pointer.enteredPosition) return ScanOutcome::Stop;
+
+        // Built-in shapes are stored in global space.
+        if (hasShape(index))
+            return shapeBuffer.intersect(index, pointer.cursor) ? ScanOutcome::Hit : ScanOutcome::Miss;
+
+        const auto handle = inputElements.getHandles()[index];
+        return elem->intersect(getTransform(*elem, handle).toLocal(pointer.cursor)) ? ScanOutcome::Hit :
+                                                                                        ScanOutcome::Miss;
+    }
+
+    void InputContext::prepareQuery()
+    {
+        if (elementsDirty || boundsDirty || treeDirty || !dirtyBounds.empty()) updateElements();
+    }
+
+    template<typename Handles>
+    size_t InputContext::queryPoint(const math::int2            point,
+                                    const size_t                limit,
+                                    std::pmr::vector<uint32_t>& scratch,
+                                    Handles&                    handles) const
+    {
+        const auto elemHandles = inputElements.getHandles();
+        size_t     count       = 0;
+        const auto test        = [&](const size_t index) {
+            if (!containsPoint(index, point)) return false;
+            handles.emplace_back(elemHandles[index]);
+            return ++count == limit;
+        };
+        if (limit == 0) return 0;
+
+        switch (hitTestMode)
+        {
+        case HitTestMode::Linear:
+            for (size_t i = 0; i < elemHandles.size(); i++)
+                if (test(i)) break;
+            break;
+        case HitTestMode::BoundsCulling:
+            for (size_t block = 0; block < shapeBuffer.getBlockCount(); block++)
+            {
+                bool done = false;
+                for (auto mask = shapeBuffer.test(block, point); mask && !done; mask &= mask - 1)
+                    done = test(block * InputShapeBuffer::blockSize + static_cast<size_t>(std::countr_zero(mask)));
+                if (done) break;
+            }
+            break;
+        case HitTestMode::SpatialIndex:
+        case HitTestMode::Hierarchy:
+            if (hitTestMode == HitTestMode::SpatialIndex)
+                spatialIndex.query(point, inputElements.getPositions(), scratch);
+            else
+                hierarchy.query(point, inputElements.getPositions(), scratch);
+            for (const auto i : scratch)
+                if (test(i)) break;
+            break;
+        }
+        return count;
+    }
+
+    bool InputContext::containsPoint(const size_t index, const math::int2 point) const noexcept
+    {
+        if (hasShape(index)) return shapeBuffer.intersect(index, point);
+        const auto* elem = inputElements.getElements()[index];
+        return elem->intersect(getTransform(*elem, inputElements.getHandles()[index]).toLocal(point));
+    }
+
+    bool InputContext::hasShape(const size_t index) const noexcept
+    {
+        return hitTestMode != HitTestMode::Linear && shapeBuffer.hasShape(index);
+    }
+
+    void InputContext::addScanStats(const Pointer& pointer, const size_t index, const ScanOutcome outcome) noexcept
+    {
+        if (outcome == ScanOutcome::Skip) return;
+        if (pointer.stillInside) addStat(InputMetric::CompareCalls);
+        if (outcome != ScanOutcome::Stop)
+            addStat(hasShape(index) ? InputMetric::ShapeTests : InputMetric::IntersectCalls);
+    }
+
+    size_t InputContext::scannedBlocks(const Pointer& pointer) const noexcept
+    {
+        const auto count = shapeBuffer.getBlockCount();
+        if (!pointer.stillInside || pointer.enteredPosition == InputHandle::invalidIndex) return count;
+        return std::min(count, pointer.enteredPosition / InputShapeBuffer::blockSize + 1);
+    }
+
+    bool InputContext::scanInParallel(const size_t count) const noexcept
+    {
+        return workerPool && workerPool->getThreadCount() > 0 && count >= parallelThreshold && count > 1;
+    }
+
+    template<typename Visit>
+    void InputContext::scanParallel(Pointer& pointer, const size_t unitCount, const Visit& visit)
+    {
+        // More chunks than threads, so that threads that finish early can take over work of others.
+        const auto chunkCount = std::min(unitCount, (workerPool->getThreadCount() + 1) * 4);
+        const auto chunkSize  = (unitCount + chunkCount - 1) / chunkCount;
+        scanChunks.assign(chunkCount, ScanChunk{});
+
+        // First unit for which a result was found. Chunks stop once they get past it.
+        std::atomic<size_t> first = unitCount;
+
+        workerPool->run(chunkCount, [&](const size_t c) {
+            auto&      chunk = scanChunks[c];
+            const auto end   = std::min(unitCount, (c + 1) * chunkSize);
+            for (auto unit = c * chunkSize; unit < end; unit++)
+            {
+                if (unit > first.load(std::memory_order_relaxed)) return;
+
+                bool found = false;
+                visit(unit, [&](const size_t index) {
+                    const auto outcome = testElement(pointer, index);
+                    if (outcome == ScanOutcome::Skip) return false;
+                    if (pointer.stillInside) chunk.compareCalls++;
+                    if (outcome != ScanOutcome::Stop && hasShape(index)) chunk.shapeTests++;
+                    if (outcome != ScanOutcome::Stop && !hasShape(index)) chunk.intersectCalls++;
+                    if (outcome == ScanOutcome::Miss) return false;
+                    chunk.outcome = outcome;
+                    chunk.index   = index;
+                    found         = true;
+                    return true;
+                });
+
+                if (found)
+                {
+                    auto current = first.load(std::memory_order_relaxed);
+                    while (unit < current && !first.compare_exchange_weak(current, unit, std::memory_order_relaxed)) {}
+                    return;
+                }
+            }
+        });
+
+        // Chunks are ordered and each one stops at its first result, so the first chunk with a result has the result
+        // of a scan on a single thread.
+        bool done = false;
+        for (const auto& chunk : scanChunks)
+        {
+            addStat(InputMetric::IntersectCalls, chunk.intersectCalls);
+            addStat(InputMetric::ShapeTests, chunk.shapeTests);
+            addStat(InputMetric::CompareCalls, chunk.compareCalls);
+            if (done || chunk.outcome == ScanOutcome::Miss) continue;
+            done = true;
+            if (chunk.outcome == ScanOutcome::Hit)
+            {
+                pointer.target       = inputElements.getElements()[chunk.index];
+                pointer.targetHandle = inputElements.getHandles()[chunk.index];
+            }
+        }
+        pointer.scanning = false;
+    }
+
+    template<typename F>
+    void InputContext::propagate(InputElement& elem, const InputHandle handle, F&& dispatch)
+    {
+        if (!propagationEnabled || propagationPaths.get(handle).empty())
+        {
+            static_cast<void>(dispatch(elem, handle, Phase::Target));
+            countDispatched();
+            return;
+        }
+
+        // Handlers can add, remove or invalidate elements, so receivers are looked up again before every call.
+        const auto path = propagationPaths.get(handle);
+        propagationPath.assign(path.begin(), path.end());
+        const auto call = [&](const InputHandle receiverHandle, const Phase phase) {
+            auto* receiver = elementRegistry.get(receiverHandle);
+            if (!receiver) return false;
+            countDispatched();
+            return dispatch(*receiver, receiverHandle, phase);
+        };
+
+        for (auto i = propagationPath.size(); i-- > 0;)
+            if (propagationPath[i].capture && call(propagationPath[i].handle, Phase::Capture)) return;
+        if (call(handle, Phase::Target)) return;
+        for (const auto& entry : propagationPath)
+            if (entry.bubble && call(entry.handle, Phase::Bubble)) return;
+    }
+
+    void InputContext::mouseMoveEvents(Pointer& pointer)
+    {
+        if (pointer.previousPreciseCursor == pointer.preciseCursor) return;
+
+        const ScopedTimer timer(collectStats(), frameStats[InputMetric::MoveTime]);
+
+        auto* elem   = pointer.claimedElement;
+        auto  handle = pointer.claimedHandle;
+        if (!elem && pointer.enteredElement)
+        {
+            elem   = pointer.enteredElement;
+            handle = pointer.enteredHandle;
+        }
+
+        if (elem)
+        {
+            const auto transform = getTransform(*elem, handle);
+            const auto offset    = toPrecise(transform.offset);
+            const auto history =
+              gatherSamples(InputEvent::Type::Cursor, pointer.id, pointer.sampleBegin, pointer.sampleEnd, offset);
+            const auto move = MouseMoveEvent{.previous        = transform.toLocal(pointer.previousCursor),
+                                             .current         = transform.toLocal(pointer.cursor),
+                                             .precisePrevious = pointer.previousPreciseCursor - offset,
+                                             .preciseCurrent  = pointer.preciseCursor - offset,
+                                             .pointer         = pointer.id,
+                                             .samples         = history};
+            static_cast<void>(elem->onMouseMove(move));
+            countDispatched();
+        }
+    }
+
+    void InputContext::mouseClickEvents(Pointer& pointer, const MouseClickEvent& click, const int64_t t)
+    {
+        const ScopedTimer timer(collectStats(), frameStats[InputMetric::ClickTime]);
+
+        // Element that receives the click.
+        auto* elem   = pointer.claimedElement ? pointer.claimedElement : pointer.enteredElement;
+        auto  handle = pointer.claimedElement ? pointer.claimedHandle : pointer.enteredHandle;
+
+        if (pointer.claimedElement)
+        {
+            bool release = false;
+            propagate(*elem, handle, [&](InputElement& receiver, InputHandle, const Phase phase) {
+                auto e   = click;
+                e.phase  = phase;
+                e.target = elem;
+                const auto result = receiver.onMouseClick(e);
+                if (phase == Phase::Target && !result.claim) release = true;
+                return result.stopPropagation;
+            });
+            if (release)
+            {
+                // The click handler can have removed the element.
+                if (pointer.claimedElement) markChanged(*pointer.claimedElement, pointer.claimedHandle);
+                pointer.claimedElement = nullptr;
+                pointer.claimedHandle  = {};
+            }
+        }
+        else if (pointer.enteredElement)
+        {
+            // An ancestor can claim the click in the capture phase to take over input from its descendants.
+            InputElement* claimer = nullptr;
+            InputHandle   claimerHandle;
+            propagate(*elem, handle, [&](InputElement& receiver, const InputHandle receiverHandle, const Phase phase) {
+                auto e   = click;
+                e.phase  = phase;
+                e.target = elem;
+                const auto result = receiver.onMouseClick(e);
+                if (result.claim && !claimer)
+                {
+                    claimer       = &receiver;
+                    claimerHandle = receiverHandle;
+                }
+                return result.stopPropagation;
+            });
+
+            // The click handler can have removed the element.
+            if (claimer && elementRegistry.get(claimerHandle) == claimer)
+            {
+                pointer.claimedElement = claimer;
+                pointer.claimedHandle  = claimerHandle;
+                markChanged(*pointer.claimedElement, pointer.claimedHandle);
+            }
+        }
+
+        timers.cancel(std::exchange(pointer.longPressTimer, {}));
+        if (click.action == MouseAction::Release || !elem) return;
+
+        pointer.longPressElement = handle;
+        if (longPressDelay > 0)
+        {
+            pointer.longPressTimer = timers.schedule(t + longPressDelay,
+                                                     Timer{.type      = Timer::Type::LongPress,
+                                                           .element   = handle,
+                                                           .pointer   = pointer.id,
+                                                           .button    = click.button,
+                                                           .modifiers = click.modifiers});
+        }
+
+        // Clicking a focusable element focuses it. The click handler can have removed the element.
+        if (focusChain.getPosition(handle) != InputHandle::invalidIndex && elementRegistry.get(handle) == elem)
+            changeFocus(elem, handle);
+
+        // Second press of the same button on the same element. The click handler can have removed the element.
+        if (doubleClickInterval > 0 && pointer.lastPressElement == handle && pointer.lastPressButton == click.button &&
+            t - pointer.lastPressTime <= doubleClickInterval && elementRegistry.get(handle) == elem)
+        {
+            pointer.lastPressElement = {};
+            static_cast<void>(elem->onDoubleClick(
+              DoubleClickEvent{.button = click.button, .modifiers = click.modifiers, .pointer = pointer.id}));
+            countDispatched();
+            return;
+        }
+
+        pointer.lastPressElement = handle;
+        pointer.lastPressButton  = click.button;
+        pointer.lastPressTime    = t;
+    }
+
+    void InputContext::updatePointerTimers(Pointer& pointer)
+    {
+        // Restart the hover delay.
+        if (pointer.cursor != pointer.previousCursor || pointer.enteredHandle != pointer.hoverTimerElement)
+        {
+            timers.cancel(std::exchange(pointer.hoverTimer, {}));
+            pointer.hoverTimerElement = pointer.enteredHandle;
+            if (hoverDelay > 0 && pointer.enteredElement)
+            {
+                pointer.hoverTimer = timers.schedule(
+                  pointer.time + hoverDelay,
+                  Timer{.type = Timer::Type::Hover, .element = pointer.enteredHandle, .pointer = pointer.id});
+            }
+        }
+
+        // Pointer exited the pressed element.
+        if (pointer.enteredHandle != pointer.longPressElement) timers.cancel(std::exchange(pointer.longPressTimer, {}));
+    }
+
+    void InputContext::fireTimers(const int64_t t)
+    {
+        timers.advance(t, expiredTimers);
+        for (const auto& expired : expiredTimers)
+        {
+            const auto& timer = expired.value;
+
+            // Key repeat follows keyboard focus.
+            if (timer.type == Timer::Type::KeyRepeat)
+            {
+                if (keyRepeatTimer != expired.handle) continue;
+
+                // Repeats that were missed because the context was not polled are skipped.
+                const auto missed = std::max<int64_t>(t - expired.deadline, 0) / keyRepeatInterval;
+                keyRepeatTimer    = timers.schedule(expired.deadline + (missed + 1) * keyRepeatInterval, timer);
+                keyEvents(KeyEvent{.key       = timer.key,
+                                   .scancode  = timer.scancode,
+                                   .action    = KeyAction::Repeat,
+                                   .modifiers = timer.modifiers},
+                          expired.deadline);
+                continue;
+            }
+
+            // Timers of removed elements are dropped lazily.
+            auto* elem = elementRegistry.get(timer.element);
+            if (!elem) continue;
+
+            switch (timer.type)
+            {
+            case Timer::Type::Hover:
+            {
+                auto& pointer = getPointer(timer.pointer);
+                if (pointer.hoverTimer == expired.handle) pointer.hoverTimer = {};
+                const auto position = getTransform(*elem, timer.element).toLocal(pointer.cursor);
+                static_cast<void>(
+                  elem->onMouseHover(MouseHoverEvent{.pointer = pointer.id, .position = position}));
+                break;
+            }
+            case Timer::Type::LongPress:
+            {
+                auto& pointer = getPointer(timer.pointer);
+                if (pointer.longPressTimer == expired.handle) pointer.longPressTimer = {};
+                const auto position = getTransform(*elem, timer.element).toLocal(pointer.cursor);
+                static_cast<void>(elem->onLongPress(LongPressEvent{.button    = timer.button,
+                                                                   .modifiers = timer.modifiers,
+                                                                   .pointer   = pointer.id,
+                                                                   .position  = position}));
+                break;
+            }
+            case Timer::Type::Element:
+                static_cast<void>(elem->onTimer(
+                  TimerEvent{.timer = expired.handle, .deadline = expired.deadline, .data = timer.data}));
+                break;
+            case Timer::Type::KeyRepeat: break;
+            }
+            countDispatched();
+        }
+        expiredTimers.clear();
+    }
+
+    void InputContext::mouseScrollEvents(Pointer& pointer, const InputEvent& event)
+    {
+        const ScopedTimer timer(collectStats(), frameStats[InputMetric::ScrollTime]);
+
+        auto* elem   = pointer.claimedElement ? pointer.claimedElement : pointer.enteredElement;
+        auto  handle = pointer.claimedElement ? pointer.claimedHandle : pointer.enteredHandle;
+        if (!elem) return;
+
+        // Fractions of a step are only carried over while the same element is scrolled. Whole steps are rounded
+        // towards zero, so that the remainder has the sign of the distance.
+        if (std::exchange(pointer.scrollHandle, handle) != handle) pointer.scrollRemainder = {};
+        const auto total        = pointer.scrollRemainder + event.value;
+        const auto steps        = math::int2(total.x / subpixelScale, total.y / subpixelScale);
+        pointer.scrollRemainder = total - math::int2(steps.x * subpixelScale, steps.y * subpixelScale);
+
+        const auto history = gatherSamples(InputEvent::Type::Scroll, pointer.id, event.sampleBegin, event.sampleEnd);
+        const auto scroll  = MouseScrollEvent{.scroll        = steps,
+                                              .preciseScroll = event.value,
+                                              .pointer       = pointer.id,
+                                              .samples       = history};
+
+        propagate(*elem, handle, [&](InputElement& receiver, InputHandle, const Phase phase) {
+            auto e   = scroll;
+            e.phase  = phase;
+            e.target = elem;
+            return receiver.onMouseScroll(e).stopPropagation;
+        });
+    }
+
+    void InputContext::keyEvents(const KeyEvent& key, const int64_t t)
+    {
+        bool handled = false;
+        if (focusedElement)
+        {
+            handled = focusedElement->onKey(key).handled;
+            countDispatched();
+        }
+
+        // Only the last pressed key repeats.
+        if (key.action == KeyAction::Press)
+        {
+            timers.cancel(std::exchange(keyRepeatTimer, {}));
+            keyRepeatKey = key.key;
+            if (keyRepeatDelay > 0)
+            {
+                keyRepeatTimer = timers.schedule(t + keyRepeatDelay,
+                                                 Timer{.type      = Timer::Type::KeyRepeat,
+                                                       .modifiers = key.modifiers,
+                                                       .key       = key.key,
+                                                       .scancode  = key.scancode});
+            }
+        }
+        else if (key.action == KeyAction::Release && key.key == keyRepeatKey)
+            timers.cancel(std::exchange(keyRepeatTimer, {}));
+
+        if (handled || key.key != tabKey || key.action == KeyAction::Release) return;
+        const auto shift = static_cast<uint32_t>(key.modifiers) & static_cast<uint32_t>(MouseModifiers::Shift);
+        focusNeighbour(shift == 0);
+    }
+
+    void InputContext::textEvents(const std::span<const char32_t> codepoints)
+    {
+        if (!focusedElement) return;
+        static_cast<void>(focusedElement->onText(TextEvent{.text = codepoints}));
+        countDispatched();
+    }
+
+    void InputContext::changeFocus(InputElement* elem, const InputHandle handle)
+    {
+        if (elem == focusedElement && handle == focusedHandle) return;
+
+        auto*      previous       = std::exchange(focusedElement, elem);
+        const auto previousHandle = std::exchange(focusedHandle, handle);
+        if (previous)
+        {
+            markChanged(*previous, previousHandle);
+            static_cast<void>(previous->onFocusExit(FocusExitEvent{}));
+            countDispatched();
+        }
+        if (elem)
+        {
+            markChanged(*elem, handle);
+            static_cast<void>(elem->onFocusEnter(FocusEnterEvent{}));
+            countDispatched();
+        }
+    }
+
+    bool InputContext::focusNeighbour(const bool forward)
+    {
+        focusChain.update(elementRegistry);
+        const auto handles = focusChain.getHandles();
+        if (handles.empty()) return false;
+
+        // Elements outside of the chain continue at either end.
+        const auto size = static_cast<uint32_t>(handles.size());
+        const auto pos  = focusChain.getPosition(focusedHandle);
+        uint32_t   next = forward ? 0 : size - 1;
+        if (pos != InputHandle::invalidIndex) next = forward ? (pos + 1) % size : (pos + size - 1) % size;
+        if (handles[next] == focusedHandle) return false;
+
+        changeFocus(elementRegistry.get(handles[next]), handles[next]);
+        return true;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Allocation counter.
+    ////////////////////////////////////////////////////////////////
+
+    InputContext::AllocationCounter::AllocationCounter(std::pmr::memory_resource* resource) noexcept :
+        upstream(resource)
+    {
+    }
+
+    void* InputContext::AllocationCounter::do_allocate(const size_t bytes, const size_t alignment)
+    {
+        if (active)
+        {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            assert(!check && "InputContext allocated memory during prePoll or postPoll");
+        }
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void InputContext::AllocationCounter::do_deallocate(void* p, const size_t bytes, const size_t alignment)
+    {
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool InputContext::AllocationCounter::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
 }  // namespace floah
@@ -20,6 +20,26 @@ namespace floah
 
     math::int2 InputElement::getInputOffset() const noexcept { return {}; }
 
+    std::optional<InputBounds> InputElement::getInputBounds() const noexcept
+    {
+        const auto shape = getInputShape();
+        if (!shape) return std::nullopt;
+        return shape->bounds;
+    }
+
+    bool InputElement::getInputClipChildren() const noexcept { return false; }
+
+    std::optional<InputShape> InputElement::getInputShape() const noexcept { return std::nullopt; }
+
+    bool InputElement::getInputFocusable() const noexcept { return false; }
+
+    int32_t InputElement::getInputTabIndex() const noexcept { return 0; }
+
+    InputContext::Propagation InputElement::getInputPropagation() const noexcept
+    {
+        return InputContext::Propagation::None;
+    }
+
     ////////////////////////////////////////////////////////////////
     // Input.
     ////////////////////////////////////////////////////////////////
@@ -62,6 +82,12 @@ namespace floah
         }
     }
 
+    bool InputElement::intersect(const math::int2 point) const noexcept
+    {
+        const auto shape = getInputShape();
+        return shape && shape->contains(point);
+    }
+
     ////////////////////////////////////////////////////////////////
     // Events.
     ////////////////////////////////////////////////////////////////
@@ -91,4 +117,41 @@ namespace floah
         return InputContext::MouseScrollResult{};
     }
 
+    InputContext::MouseHoverResult InputElement::onMouseHover(const InputContext::MouseHoverEvent&)
+    {
+        return InputContext::MouseHoverResult{};
+    }
+
+    InputContext::LongPressResult InputElement::onLongPress(const InputContext::LongPressEvent&)
+    {
+        return InputContext::LongPressResult{};
+    }
+
+    InputContext::DoubleClickResult InputElement::onDoubleClick(const InputContext::DoubleClickEvent&)
+    {
+        return InputContext::DoubleClickResult{};
+    }
+
+    InputContext::TimerResult InputElement::onTimer(const InputContext::TimerEvent&)
+    {
+        return InputContext::TimerResult{};
+    }
+
+    InputContext::FocusEnterResult InputElement::onFocusEnter(const InputContext::FocusEnterEvent&)
+    {
+        return InputContext::FocusEnterResult{};
+    }
+
+    InputContext::FocusExitResult InputElement::onFocusExit(const InputContext::FocusExitEvent&)
+    {
+        return InputContext::FocusExitResult{};
+    }
+
+    InputContext::KeyResult InputElement::onKey(const InputContext::KeyEvent&) { return InputContext::KeyResult{}; }
+
+    InputContext::TextResult InputElement::onText(const InputContext::TextEvent&)
+    {
+        return InputContext::TextResult{};
+    }
+
 }  // namespace floah
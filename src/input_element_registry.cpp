@@ -0,0 +1,107 @@
+#include "floah-put/input_element_registry.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputElementRegistry::InputElementRegistry(std::pmr::memory_resource* resource) :
+        slots(resource), freeSlots(resource), elements(resource), handles(resource), lookup(resource)
+    {
+    }
+
+    InputElementRegistry::~InputElementRegistry() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t InputElementRegistry::size() const noexcept { return elements.size(); }
+
+    size_t InputElementRegistry::getSlotCount() const noexcept { return slots.size(); }
+
+    std::span<InputElement* const> InputElementRegistry::getElements() const noexcept { return elements; }
+
+    std::span<const InputHandle> InputElementRegistry::getHandles() const noexcept { return handles; }
+
+    bool InputElementRegistry::contains(const InputHandle handle) const noexcept
+    {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+    }
+
+    InputElement* InputElementRegistry::get(const InputHandle handle) const noexcept
+    {
+        return contains(handle) ? elements[slots[handle.index].dense] : nullptr;
+    }
+
+    InputHandle InputElementRegistry::find(const InputElement& elem) const noexcept
+    {
+        if (const auto it = lookup.find(&elem); it != lookup.end())
+            return InputHandle{.index = it->second, .generation = slots[it->second].generation};
+        return InputHandle{};
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Elements.
+    ////////////////////////////////////////////////////////////////
+
+    void InputElementRegistry::reserve(const size_t count)
+    {
+        slots.reserve(count);
+        elements.reserve(count);
+        handles.reserve(count);
+        lookup.reserve(count);
+    }
+
+    InputHandle InputElementRegistry::add(InputElement& elem)
+    {
+        if (const auto handle = find(elem); handle.valid()) return handle;
+
+        // Reuse a free slot or create a new one.
+        uint32_t index;
+        if (freeSlots.empty())
+        {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        else
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+
+        auto& slot = slots[index];
+        slot.dense = static_cast<uint32_t>(elements.size());
+        const InputHandle handle{.index = index, .generation = slot.generation};
+        elements.emplace_back(&elem);
+        handles.emplace_back(handle);
+        lookup.emplace(&elem, index);
+
+        return handle;
+    }
+
+    bool InputElementRegistry::remove(const InputHandle handle)
+    {
+        if (!contains(handle)) return false;
+
+        // Move last element into place of removed element.
+        auto&      slot = slots[handle.index];
+        const auto last = static_cast<uint32_t>(elements.size() - 1);
+        lookup.erase(elements[slot.dense]);
+        if (slot.dense != last)
+        {
+            elements[slot.dense]                    = elements[last];
+            handles[slot.dense]                     = handles[last];
+            slots[handles[slot.dense].index].dense = slot.dense;
+        }
+        elements.pop_back();
+        handles.pop_back();
+
+        // Bump generation so that existing handles to this slot become invalid.
+        slot.generation++;
+        freeSlots.emplace_back(handle.index);
+
+        return true;
+    }
+}  // namespace floah
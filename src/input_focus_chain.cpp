@@ -0,0 +1,119 @@
+#include "floah-put/input_focus_chain.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_element.h"
+#include "floah-put/input_element_registry.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputFocusChain::InputFocusChain(std::pmr::memory_resource* resource) :
+        entries(resource), handles(resource), positions(resource), sequences(resource), invalidated(resource)
+    {
+    }
+
+    InputFocusChain::~InputFocusChain() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::span<const InputHandle> InputFocusChain::getHandles() const noexcept { return handles; }
+
+    uint32_t InputFocusChain::getPosition(const InputHandle handle) const noexcept
+    {
+        if (handle.index >= positions.size()) return InputHandle::invalidIndex;
+        const auto pos = positions[handle.index];
+        return pos < handles.size() && handles[pos] == handle ? pos : InputHandle::invalidIndex;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Elements.
+    ////////////////////////////////////////////////////////////////
+
+    void InputFocusChain::add(const InputHandle handle, const InputElement& elem)
+    {
+        if (handle.index >= sequences.size()) sequences.resize(handle.index + 1);
+        sequences[handle.index] = nextSequence++;
+
+        if (!elem.getInputFocusable()) return;
+        invalidated.emplace_back(handle);
+        dirty = true;
+    }
+
+    void InputFocusChain::remove(const InputHandle handle) noexcept
+    {
+        // Only removing an element that is in the chain changes it.
+        if (getPosition(handle) != InputHandle::invalidIndex) dirty = true;
+    }
+
+    void InputFocusChain::invalidate(const InputHandle handle)
+    {
+        invalidated.emplace_back(handle);
+        dirty = true;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Update.
+    ////////////////////////////////////////////////////////////////
+
+    bool InputFocusChain::update(const InputElementRegistry& registry)
+    {
+        if (!dirty) return false;
+        dirty = false;
+
+        // An element can be invalidated several times.
+        std::ranges::sort(invalidated, [](const InputHandle lhs, const InputHandle rhs) {
+            return lhs.index != rhs.index ? lhs.index < rhs.index : lhs.generation < rhs.generation;
+        });
+        const auto [first, last] = std::ranges::unique(invalidated);
+        invalidated.erase(first, last);
+
+        // Query invalidated elements. Entries of elements that are no longer focusable are dropped below, together
+        // with those of removed elements.
+        for (const auto handle : invalidated)
+        {
+            const auto* elem = registry.get(handle);
+            if (!elem) continue;
+
+            const auto pos = getPosition(handle);
+            if (elem->getInputFocusable())
+            {
+                if (pos != InputHandle::invalidIndex)
+                    entries[pos].tabIndex = elem->getInputTabIndex();
+                else
+                    entries.emplace_back(Entry{
+                      .handle = handle, .tabIndex = elem->getInputTabIndex(), .sequence = sequences[handle.index]});
+            }
+            else if (pos != InputHandle::invalidIndex)
+                entries[pos].handle = {};
+        }
+        invalidated.clear();
+
+        std::erase_if(entries, [&registry](const Entry& entry) { return !registry.contains(entry.handle); });
+        std::ranges::sort(entries, [](const Entry& lhs, const Entry& rhs) {
+            return lhs.tabIndex != rhs.tabIndex ? lhs.tabIndex < rhs.tabIndex : lhs.sequence < rhs.sequence;
+        });
+
+        handles.resize(entries.size());
+        positions.resize(registry.getSlotCount(), InputHandle::invalidIndex);
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            handles[i]                         = entries[i].handle;
+            positions[entries[i].handle.index] = static_cast<uint32_t>(i);
+        }
+        return true;
+    }
+}  // namespace floah
@@ -0,0 +1,215 @@
+#include "floah-put/input_hierarchy.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_element.h"
+#include "floah-put/input_tree.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputHierarchy::InputHierarchy(std::pmr::memory_resource* resource) :
+        steps(resource), elementSteps(resource), clipSteps(resource), stack(resource), clips(resource), found(resource)
+    {
+    }
+
+    InputHierarchy::~InputHierarchy() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Hierarchy.
+    ////////////////////////////////////////////////////////////////
+
+    void InputHierarchy::build(const InputTree&                  tree,
+                               const std::span<const uint32_t>   positions,
+                               const std::span<const math::int2> offsets)
+    {
+        clear();
+
+        const auto nodes = tree.getNodes();
+        elementSteps.assign(positions.size(), InputTree::none);
+        clipSteps.assign(nodes.size(), InputTree::none);
+
+        // Walk tree top-down and emit steps. Descendants are emitted before the element itself.
+        stack.clear();
+
+        const auto enter = [&](const uint32_t n) {
+            const auto& node = nodes[n];
+            Frame       f{.node = n, .next = node.firstChild, .clipStep = InputTree::none};
+            if (node.firstChild != InputTree::none && node.element->getInputClipChildren())
+            {
+                if (const auto bounds = node.element->getInputBounds(); bounds)
+                {
+                    // Offset of added elements is taken from the list, others are queried.
+                    const auto offset = node.handle.valid() ? offsets[positions[node.handle.index]] :
+                                                              node.element->getInputOffset();
+                    f.clipStep   = static_cast<uint32_t>(steps.size());
+                    clipSteps[n] = f.clipStep;
+                    steps.emplace_back(Step{.type    = Step::Type::Clip,
+                                            .bounded = true,
+                                            .index   = n,
+                                            .skip    = 0,
+                                            .bounds  = bounds->translate(offset)});
+                }
+            }
+            stack.emplace_back(f);
+        };
+
+        for (auto root = tree.getFirstRoot(); root != InputTree::none; root = nodes[root].nextSibling)
+        {
+            enter(root);
+            while (!stack.empty())
+            {
+                const auto  f    = stack.back();
+                const auto& node = nodes[f.node];
+
+                // Visit next child.
+                if (f.next != InputTree::none)
+                {
+                    stack.back().next = nodes[f.next].nextSibling;
+                    enter(f.next);
+                    continue;
+                }
+
+                // All children were visited. Emit element itself.
+                if (node.handle.valid())
+                {
+                    Step step{.type = Step::Type::Element, .index = node.handle.index};
+                    if (const auto bounds = node.element->getInputBounds(); bounds)
+                    {
+                        step.bounded = true;
+                        step.bounds  = bounds->translate(offsets[positions[node.handle.index]]);
+                    }
+                    elementSteps[node.handle.index] = static_cast<uint32_t>(steps.size());
+                    steps.emplace_back(step);
+                }
+
+                if (f.clipStep != InputTree::none) steps[f.clipStep].skip = static_cast<uint32_t>(steps.size());
+                stack.pop_back();
+            }
+        }
+    }
+
+    bool InputHierarchy::update(const InputTree& tree, const uint32_t node, const math::int2 offset)
+    {
+        const auto& n      = tree.getNodes()[node];
+        const auto  bounds = n.element->getInputBounds();
+
+        // A clipping step can only be updated, not added or removed.
+        const auto clipStep = node < clipSteps.size() ? clipSteps[node] : InputTree::none;
+        const auto clips    = n.firstChild != InputTree::none && bounds && n.element->getInputClipChildren();
+        if (clips != (clipStep != InputTree::none)) return false;
+        if (clips) steps[clipStep].bounds = bounds->translate(offset);
+
+        if (!n.handle.valid() || n.handle.index >= elementSteps.size()) return true;
+        const auto step = elementSteps[n.handle.index];
+        if (step == InputTree::none) return true;
+        steps[step].bounded = bounds.has_value();
+        steps[step].bounds  = bounds ? bounds->translate(offset) : InputBounds{};
+        return true;
+    }
+
+    void InputHierarchy::remove(const InputHandle handle) noexcept
+    {
+        if (handle.index >= elementSteps.size()) return;
+        const auto step = std::exchange(elementSteps[handle.index], InputTree::none);
+        if (step == InputTree::none) return;
+
+        // Inverted bounds contain no point and overlap no region.
+        constexpr auto min  = std::numeric_limits<int32_t>::min();
+        constexpr auto max  = std::numeric_limits<int32_t>::max();
+        steps[step].bounded = true;
+        steps[step].bounds  = InputBounds{.lower = math::int2(max, max), .upper = math::int2(min, min)};
+    }
+
+    void InputHierarchy::clear() noexcept
+    {
+        steps.clear();
+        elementSteps.clear();
+        clipSteps.clear();
+    }
+
+    void InputHierarchy::query(const math::int2                point,
+                               const std::span<const uint32_t> positions,
+                               std::pmr::vector<uint32_t>&     candidates) const
+    {
+        candidates.clear();
+
+        for (size_t i = 0; i < steps.size();)
+        {
+            const auto& step = steps[i];
+            if (step.type == Step::Type::Clip)
+            {
+                // Skip entire subtree if point is outside of clipping element.
+                i = step.bounds.contains(point) ? i + 1 : step.skip;
+                continue;
+            }
+
+            if (!step.bounded || step.bounds.contains(point)) candidates.emplace_back(positions[step.index]);
+            i++;
+        }
+
+        // The walk visits subtrees one at a time and siblings in no particular order. Candidates are tested in the
+        // order of the list, so that the first hit is the same as in a linear scan.
+        std::ranges::sort(candidates);
+    }
+
+    void InputHierarchy::query(const InputBounds&              region,
+                               const std::span<const uint32_t> positions,
+                               std::pmr::vector<uint32_t>&     candidates,
+                               std::pmr::vector<InputBounds>&  candidateBounds)
+    {
+        candidates.clear();
+        candidateBounds.clear();
+        found.clear();
+
+        // Clipping elements that partially overlap the region are entered. Bounds of candidates are clipped by all
+        // entered clipping elements, so that testing them against a point gives the same result as a point query.
+        constexpr auto min = std::numeric_limits<int32_t>::min();
+        constexpr auto max = std::numeric_limits<int32_t>::max();
+        clips.clear();
+        clips.emplace_back(Clip{.end    = steps.size(),
+                                .bounds = InputBounds{.lower = math::int2(min, min), .upper = math::int2(max, max)}});
+
+        for (size_t i = 0; i < steps.size();)
+        {
+            while (i >= clips.back().end) clips.pop_back();
+
+            const auto& step = steps[i];
+            const auto  clip = step.bounded ? step.bounds.clip(clips.back().bounds) : clips.back().bounds;
+            if (step.type == Step::Type::Clip)
+            {
+                if (clip.overlaps(region))
+                {
+                    clips.emplace_back(Clip{.end = step.skip, .bounds = clip});
+                    i++;
+                }
+                else
+                    i = step.skip;
+                continue;
+            }
+
+            if (clip.overlaps(region)) found.emplace_back(Candidate{.index = positions[step.index], .bounds = clip});
+            i++;
+        }
+
+        std::ranges::sort(found, {}, &Candidate::index);
+        for (const auto& candidate : found)
+        {
+            candidates.emplace_back(candidate.index);
+            candidateBounds.emplace_back(candidate.bounds);
+        }
+    }
+}  // namespace floah
@@ -0,0 +1,308 @@
+#include "floah-put/input_layer_order.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_element.h"
+#include "floah-put/input_element_registry.h"
+#include "floah-put/input_tree.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputLayerOrder::InputLayerOrder(std::pmr::memory_resource* resource) :
+        entries(resource),
+        pending(resource),
+        elements(resource),
+        handles(resource),
+        positions(resource),
+        invalidated(resource),
+        removed(resource),
+        keyPool(resource),
+        pathPool(resource),
+        scratchPool(resource),
+        scratchPathPool(resource),
+        affected(resource),
+        order(resource),
+        merged(resource)
+    {
+    }
+
+    InputLayerOrder::~InputLayerOrder() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::span<InputElement* const> InputLayerOrder::getElements() const noexcept { return elements; }
+
+    std::span<const InputHandle> InputLayerOrder::getHandles() const noexcept { return handles; }
+
+    uint32_t InputLayerOrder::getPosition(const InputHandle handle) const noexcept
+    {
+        if (handle.index >= positions.size()) return InputHandle::invalidIndex;
+        const auto pos = positions[handle.index];
+        return pos < handles.size() && handles[pos] == handle ? pos : InputHandle::invalidIndex;
+    }
+
+    std::span<const uint32_t> InputLayerOrder::getPositions() const noexcept { return positions; }
+
+    InputLayerOrder::Range InputLayerOrder::getChanged() const noexcept { return changed; }
+
+    void InputLayerOrder::findSubtree(const InputElement& root, std::pmr::vector<InputHandle>& handles) const
+    {
+        // The root is at the same depth in the path of every element of its subtree.
+        uint32_t depth = 0;
+        for (const auto* e = root.getInputParent(); e; e = e->getInputParent()) depth++;
+
+        for (const auto& entry : entries)
+            if (entry.keySize > depth && pathPool[entry.keyOffset + depth] == &root) handles.emplace_back(entry.handle);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Elements.
+    ////////////////////////////////////////////////////////////////
+
+    void InputLayerOrder::reserve(const size_t count)
+    {
+        entries.reserve(count);
+        pending.reserve(count);
+        elements.reserve(count);
+        handles.reserve(count);
+        positions.reserve(count);
+    }
+
+    void InputLayerOrder::add(const InputHandle handle, InputElement& elem)
+    {
+        pending.emplace_back(Entry{.handle = handle, .element = &elem});
+    }
+
+    void InputLayerOrder::remove(const InputHandle handle) { removed.emplace_back(handle); }
+
+    void InputLayerOrder::invalidate(const InputElement& elem) { invalidated.emplace_back(&elem); }
+
+    ////////////////////////////////////////////////////////////////
+    // Update.
+    ////////////////////////////////////////////////////////////////
+
+    bool InputLayerOrder::update(const InputElementRegistry& registry, const InputTree& tree, const bool full)
+    {
+        if (!full && pending.empty() && invalidated.empty() && removed.empty()) return false;
+
+        // Drop pending entries that were removed before they were ever sorted.
+        std::erase_if(pending, [&registry](const Entry& entry) { return !registry.contains(entry.handle); });
+        const auto added = pending.size();
+
+        gatherAffected(tree, full);
+
+        // Recalculate keys of affected entries. Entries whose key did not change stay where they are. Changed entries
+        // are moved to the pending list to be reinserted, and removed entries are dropped. Both leave a gap, whose
+        // position is kept in the affected list.
+        size_t gaps = 0;
+        for (const auto pos : affected)
+        {
+            auto& entry = entries[pos];
+            if (!registry.contains(entry.handle))
+            {
+                garbage += entry.keySize;
+                affected[gaps++] = pos;
+                continue;
+            }
+
+            // The new key is appended to the pools, and taken back off if neither key nor path changed.
+            const auto old = entry;
+            calculateKey(*entry.element, entry);
+            const auto oldKey  = std::span(keyPool).subspan(old.keyOffset, old.keySize);
+            const auto newKey  = std::span(keyPool).subspan(entry.keyOffset, entry.keySize);
+            const auto oldPath = std::span(pathPool).subspan(old.keyOffset, old.keySize);
+            const auto newPath = std::span(pathPool).subspan(entry.keyOffset, entry.keySize);
+            const auto sameKey = std::ranges::equal(oldKey, newKey);
+            if (sameKey && std::ranges::equal(oldPath, newPath))
+            {
+                keyPool.resize(entry.keyOffset);
+                pathPool.resize(entry.keyOffset);
+                entry = old;
+                continue;
+            }
+
+            garbage += old.keySize;
+            if (sameKey) continue;
+            pending.emplace_back(entry);
+            affected[gaps++] = pos;
+        }
+        affected.resize(gaps);
+
+        // Calculate keys of newly added entries. Changed entries already have theirs.
+        for (size_t i = 0; i < added; i++) calculateKey(*pending[i].element, pending[i]);
+
+        if (affected.empty() && pending.empty())
+        {
+            if (garbage > keyPool.size() / 2) compactKeys();
+            return false;
+        }
+
+        // Sort pending entries. Sorting indices with the index as tie-break gives the same order as std::stable_sort,
+        // without its temporary buffer.
+        order.resize(pending.size());
+        std::iota(order.begin(), order.end(), uint32_t{0});
+        std::ranges::sort(order, [this](const uint32_t lhs, const uint32_t rhs) {
+            if (compare(pending[lhs], pending[rhs])) return true;
+            return !compare(pending[rhs], pending[lhs]) && lhs < rhs;
+        });
+
+        // Entries before the first gap and before the insert position of the first pending entry stay where they are.
+        // Remaining entries go first if keys are equal.
+        auto begin = affected.empty() ? entries.size() : size_t{affected.front()};
+        if (!order.empty())
+        {
+            const auto last = entries.begin() + static_cast<std::ptrdiff_t>(begin);
+            const auto less = [this](const Entry& lhs, const Entry& rhs) { return compare(lhs, rhs); };
+            const auto it   = std::upper_bound(entries.begin(), last, pending[order.front()], less);
+            begin           = static_cast<size_t>(it - entries.begin());
+        }
+
+        // Merge pending entries with the remaining entries into a second list, skipping gaps, until all pending entries
+        // were inserted and all gaps passed. The merged entries then replace that range.
+        merged.clear();
+        size_t i    = begin;
+        size_t gap  = 0;
+        size_t next = 0;
+        while (next < order.size() || gap < affected.size())
+        {
+            if (gap < affected.size() && affected[gap] == i)
+            {
+                gap++;
+                i++;
+            }
+            else if (next < order.size() && (i == entries.size() || compare(pending[order[next]], entries[i])))
+                merged.emplace_back(pending[order[next++]]);
+            else
+                merged.emplace_back(entries[i++]);
+        }
+
+        const auto replaced = static_cast<std::ptrdiff_t>(i - begin);
+        const auto count    = static_cast<std::ptrdiff_t>(merged.size());
+        const auto first    = entries.begin() + static_cast<std::ptrdiff_t>(begin);
+        if (count > replaced)
+            entries.insert(first + replaced, merged.size() - (i - begin), Entry{});
+        else
+            entries.erase(first + count, first + replaced);
+        std::ranges::copy(merged, entries.begin() + static_cast<std::ptrdiff_t>(begin));
+        pending.clear();
+
+        // If the number of entries changed, all entries after the range moved as well.
+        const auto end = count == replaced ? begin + merged.size() : entries.size();
+        changed        = Range{.begin = static_cast<uint32_t>(begin), .end = static_cast<uint32_t>(end)};
+        updateMirrors(changed);
+
+        if (garbage > keyPool.size() / 2) compactKeys();
+        return true;
+    }
+
+    void InputLayerOrder::gatherAffected(const InputTree& tree, const bool full)
+    {
+        affected.clear();
+        if (full)
+        {
+            affected.resize(entries.size());
+            std::iota(affected.begin(), affected.end(), uint32_t{0});
+        }
+        else
+        {
+            for (const auto handle : removed)
+                if (const auto pos = getPosition(handle); pos != InputHandle::invalidIndex) affected.emplace_back(pos);
+
+            // All elements whose path contains an invalidated element are in its subtree.
+            const auto nodes = tree.getNodes();
+            for (const auto* elem : invalidated)
+            {
+                const auto root = tree.find(*elem);
+                for (auto n = root; n != InputTree::none; n = tree.getNext(n, root))
+                {
+                    const auto pos = getPosition(nodes[n].handle);
+                    if (pos != InputHandle::invalidIndex) affected.emplace_back(pos);
+                }
+            }
+
+            // Elements can be affected more than once.
+            std::ranges::sort(affected);
+            const auto [first, last] = std::ranges::unique(affected);
+            affected.erase(first, last);
+        }
+
+        removed.clear();
+        invalidated.clear();
+    }
+
+    void InputLayerOrder::compactKeys()
+    {
+        scratchPool.clear();
+        scratchPathPool.clear();
+        for (auto& entry : entries)
+        {
+            const auto offset = static_cast<uint32_t>(scratchPool.size());
+            const auto begin  = static_cast<std::ptrdiff_t>(entry.keyOffset);
+            const auto end    = begin + static_cast<std::ptrdiff_t>(entry.keySize);
+            scratchPool.insert(scratchPool.end(), keyPool.begin() + begin, keyPool.begin() + end);
+            scratchPathPool.insert(scratchPathPool.end(), pathPool.begin() + begin, pathPool.begin() + end);
+            entry.keyOffset = offset;
+        }
+        std::swap(keyPool, scratchPool);
+        std::swap(pathPool, scratchPathPool);
+        garbage = 0;
+    }
+
+    void InputLayerOrder::updateMirrors(const Range range)
+    {
+        elements.resize(entries.size());
+        handles.resize(entries.size());
+        for (auto i = range.begin; i < range.end; i++)
+        {
+            elements[i]      = entries[i].element;
+            handles[i]       = entries[i].handle;
+            const auto index = handles[i].index;
+            if (index >= positions.size()) positions.resize(index + 1, InputHandle::invalidIndex);
+            positions[index] = i;
+        }
+    }
+
+    void InputLayerOrder::calculateKey(const InputElement& elem, Entry& entry)
+    {
+        // Collect layers from element up to root, then reverse to get the path from root down to element.
+        entry.keyOffset = static_cast<uint32_t>(keyPool.size());
+        for (const auto* e = &elem; e; e = e->getInputParent())
+        {
+            keyPool.emplace_back(e->getInputLayer());
+            pathPool.emplace_back(e);
+        }
+        std::reverse(keyPool.begin() + entry.keyOffset, keyPool.end());
+        std::reverse(pathPool.begin() + entry.keyOffset, pathPool.end());
+        entry.keySize = static_cast<uint32_t>(keyPool.size()) - entry.keyOffset;
+    }
+
+    bool InputLayerOrder::compare(const Entry& lhs, const Entry& rhs) const noexcept
+    {
+        const auto* keyL = keyPool.data() + lhs.keyOffset;
+        const auto* keyR = keyPool.data() + rhs.keyOffset;
+        const auto  size = std::min(lhs.keySize, rhs.keySize);
+
+        // Compare layers on the path from the root down. First difference decides.
+        for (uint32_t i = 0; i < size; i++)
+            if (keyL[i] != keyR[i]) return keyL[i] > keyR[i];
+
+        // One path is a prefix of the other. Descendant should be placed on top.
+        return lhs.keySize > rhs.keySize;
+    }
+}  // namespace floah
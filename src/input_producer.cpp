@@ -0,0 +1,146 @@
+#include "floah-put/input_producer.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputProducer::InputProducer(const size_t capacity, InputSignal* s) : queue(capacity), signal(s) {}
+
+    InputProducer::~InputProducer() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t InputProducer::getDroppedEventCount() const noexcept
+    {
+        return droppedEvents.load(std::memory_order_relaxed);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t InputProducer::getCapacity() const noexcept { return queue.capacity(); }
+
+    void InputProducer::setTime(const int64_t t) noexcept { time = t; }
+
+    void InputProducer::setTimestamp(const int64_t ns) noexcept { timestamp = ns; }
+
+    void InputProducer::setEnter(const bool e) noexcept { setEnter(InputContext::mousePointer, e); }
+
+    void InputProducer::setEnter(const uint32_t pointer, const bool e) noexcept
+    {
+        push(InputContext::InputEvent{
+          .type = InputContext::InputEvent::Type::Enter, .time = time, .enter = e, .pointer = pointer});
+    }
+
+    void InputProducer::setCursor(const math::int2 c) noexcept { setCursor(InputContext::mousePointer, c); }
+
+    void InputProducer::setCursor(const uint32_t pointer, const math::int2 c) noexcept
+    {
+        setPreciseCursor(pointer, InputContext::toPrecise(c));
+    }
+
+    void InputProducer::setPreciseCursor(const math::int2 c) noexcept
+    {
+        setPreciseCursor(InputContext::mousePointer, c);
+    }
+
+    void InputProducer::setPreciseCursor(const uint32_t pointer, const math::int2 c) noexcept
+    {
+        push(InputContext::InputEvent{
+          .type = InputContext::InputEvent::Type::Cursor, .time = time, .value = c, .pointer = pointer});
+    }
+
+    void InputProducer::setMouseButton(const InputContext::MouseButton    button,
+                                       const InputContext::MouseAction    action,
+                                       const InputContext::MouseModifiers mods) noexcept
+    {
+        setMouseButton(InputContext::mousePointer, button, action, mods);
+    }
+
+    void InputProducer::setMouseButton(const uint32_t                     pointer,
+                                       const InputContext::MouseButton    button,
+                                       const InputContext::MouseAction    action,
+                                       const InputContext::MouseModifiers mods) noexcept
+    {
+        push(InputContext::InputEvent{
+          .type    = InputContext::InputEvent::Type::Button,
+          .time    = time,
+          .click   = {.button = button, .action = action, .modifiers = mods, .pointer = pointer},
+          .pointer = pointer});
+    }
+
+    void InputProducer::setScroll(const math::int2 s) noexcept { setScroll(InputContext::mousePointer, s); }
+
+    void InputProducer::setScroll(const uint32_t pointer, const math::int2 s) noexcept
+    {
+        setPreciseScroll(pointer, InputContext::toPrecise(s));
+    }
+
+    void InputProducer::setPreciseScroll(const math::int2 s) noexcept
+    {
+        setPreciseScroll(InputContext::mousePointer, s);
+    }
+
+    void InputProducer::setPreciseScroll(const uint32_t pointer, const math::int2 s) noexcept
+    {
+        push(InputContext::InputEvent{
+          .type = InputContext::InputEvent::Type::Scroll, .time = time, .value = s, .pointer = pointer});
+    }
+
+    void InputProducer::setKey(const int32_t                      key,
+                               const int32_t                      scancode,
+                               const InputContext::KeyAction      action,
+                               const InputContext::MouseModifiers mods) noexcept
+    {
+        push(InputContext::InputEvent{
+          .type = InputContext::InputEvent::Type::Key,
+          .time = time,
+          .key  = {.key = key, .scancode = scancode, .action = action, .modifiers = mods}});
+    }
+
+    void InputProducer::setText(const char32_t codepoint) noexcept
+    {
+        push(InputContext::InputEvent{
+          .type = InputContext::InputEvent::Type::Text, .time = time, .codepoint = codepoint});
+    }
+
+    void InputProducer::setText(const std::u32string_view codepoints) noexcept
+    {
+        for (const auto codepoint : codepoints) setText(codepoint);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Queue.
+    ////////////////////////////////////////////////////////////////
+
+    void InputProducer::push(const InputContext::InputEvent& event) noexcept
+    {
+        // Whether the latency of events is measured is only known to the context, so events are always stamped.
+        auto e      = event;
+        e.timestamp = timestamp;
+        if (e.timestamp == 0)
+            e.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+
+        if (!queue.push(e))
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        else if (signal)
+            signal->notify();
+    }
+
+    bool InputProducer::pop(InputContext::InputEvent& event) noexcept { return queue.pop(event); }
+
+    bool InputProducer::empty() const noexcept { return queue.empty(); }
+}  // namespace floah
@@ -0,0 +1,94 @@
+#include "floah-put/input_propagation_paths.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_element.h"
+#include "floah-put/input_tree.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputPropagationPaths::InputPropagationPaths(std::pmr::memory_resource* resource) :
+        entries(resource), paths(resource), handles(resource), nodePaths(resource), stack(resource)
+    {
+    }
+
+    InputPropagationPaths::~InputPropagationPaths() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::span<const InputPropagationPaths::Entry> InputPropagationPaths::get(const InputHandle handle) const noexcept
+    {
+        if (handle.index >= paths.size() || handles[handle.index] != handle) return {};
+        const auto path = paths[handle.index];
+        return std::span(entries).subspan(path.offset, path.count);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Paths.
+    ////////////////////////////////////////////////////////////////
+
+    void InputPropagationPaths::build(const InputTree& tree, const size_t slotCount)
+    {
+        entries.clear();
+        paths.assign(slotCount, Path{});
+        handles.assign(slotCount, InputHandle{});
+
+        // Walk the tree top-down, so that the path of the parent is known when visiting a node.
+        const auto nodes = tree.getNodes();
+        nodePaths.assign(nodes.size(), Path{});
+        for (auto root = tree.getFirstRoot(); root != InputTree::none; root = nodes[root].nextSibling)
+            stack.emplace_back(root);
+        while (!stack.empty())
+        {
+            const auto  index = stack.back();
+            const auto& node  = nodes[index];
+            stack.pop_back();
+
+            // Only ancestors that were added to the context can receive events. All children share the same path,
+            // which is that of the node itself if it does not listen.
+            const auto propagation = node.handle.valid() && node.firstChild != InputTree::none ?
+                                       node.element->getInputPropagation() :
+                                       InputContext::Propagation::None;
+            auto childPath = nodePaths[index];
+            if (propagation != InputContext::Propagation::None)
+            {
+                childPath = Path{.offset = static_cast<uint32_t>(entries.size()), .count = nodePaths[index].count + 1};
+                entries.emplace_back(Entry{.handle  = node.handle,
+                                           .capture = propagation != InputContext::Propagation::Bubble,
+                                           .bubble  = propagation != InputContext::Propagation::Capture});
+                for (uint32_t i = 0; i < nodePaths[index].count; i++)
+                {
+                    const auto entry = entries[nodePaths[index].offset + i];
+                    entries.emplace_back(entry);
+                }
+            }
+
+            for (auto child = node.firstChild; child != InputTree::none; child = nodes[child].nextSibling)
+            {
+                nodePaths[child] = childPath;
+                stack.emplace_back(child);
+            }
+
+            if (node.handle.valid())
+            {
+                paths[node.handle.index]   = nodePaths[index];
+                handles[node.handle.index] = node.handle;
+            }
+        }
+    }
+
+    void InputPropagationPaths::clear() noexcept
+    {
+        entries.clear();
+        paths.clear();
+        handles.clear();
+    }
+}  // namespace floah
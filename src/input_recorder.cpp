@@ -0,0 +1,155 @@
+#include "floah-put/input_recorder.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <fstream>
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputRecorder::InputRecorder() { clear(); }
+
+    InputRecorder::~InputRecorder() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::span<const std::byte> InputRecorder::getData() const noexcept { return data; }
+
+    size_t InputRecorder::getFrameCount() const noexcept { return frameCount; }
+
+    ////////////////////////////////////////////////////////////////
+    // Recording.
+    ////////////////////////////////////////////////////////////////
+
+    void InputRecorder::clear()
+    {
+        data.clear();
+        frameCount = 0;
+        time       = 0;
+        pointer    = InputContext::mousePointer;
+        cursors.clear();
+
+        for (const auto value : {magic, version})
+            for (uint32_t i = 0; i < 4; i++) writeByte(static_cast<uint8_t>(value >> (i * 8)));
+    }
+
+    bool InputRecorder::save(const std::filesystem::path& path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(file);
+    }
+
+    void InputRecorder::recordPrePoll() { writeRecord(Record::PrePoll); }
+
+    void InputRecorder::recordPostPoll()
+    {
+        writeRecord(Record::PostPoll);
+        frameCount++;
+    }
+
+    void InputRecorder::recordTime(const int64_t t)
+    {
+        if (t == time) return;
+        writeRecord(Record::Time);
+        writeVarint(t - time);
+        time = t;
+    }
+
+    void InputRecorder::recordFocus(const bool f)
+    {
+        writeRecord(Record::Focus);
+        writeByte(f ? 1 : 0);
+    }
+
+    void InputRecorder::recordEvent(const InputContext::InputEvent& event)
+    {
+        // Keyboard events do not belong to a pointer.
+        if (event.type == InputContext::InputEvent::Type::Key)
+        {
+            writeRecord(Record::Key);
+            writeVarint(event.time - time);
+            writeVarint(event.key.key);
+            writeVarint(event.key.scancode);
+            writeByte(static_cast<uint8_t>(event.key.action));
+            writeByte(static_cast<uint8_t>(event.key.modifiers));
+            return;
+        }
+        if (event.type == InputContext::InputEvent::Type::Text)
+        {
+            writeRecord(Record::Text);
+            writeVarint(event.time - time);
+            writeVarint(event.codepoint);
+            return;
+        }
+
+        if (event.pointer != pointer)
+        {
+            writeRecord(Record::Pointer);
+            writeVarint(event.pointer);
+            pointer = event.pointer;
+        }
+
+        switch (event.type)
+        {
+        case InputContext::InputEvent::Type::Cursor:
+        {
+            auto it = std::ranges::find(cursors, pointer, &std::pair<uint32_t, math::int2>::first);
+            if (it == cursors.end()) it = cursors.emplace(cursors.end(), pointer, math::int2{});
+            writeRecord(Record::Cursor);
+            writeVarint(event.time - time);
+            writeVarint(static_cast<int64_t>(event.value.x) - it->second.x);
+            writeVarint(static_cast<int64_t>(event.value.y) - it->second.y);
+            it->second = event.value;
+            break;
+        }
+        case InputContext::InputEvent::Type::Button:
+            writeRecord(Record::Button);
+            writeVarint(event.time - time);
+            writeByte(static_cast<uint8_t>(static_cast<uint32_t>(event.click.button) |
+                                           static_cast<uint32_t>(event.click.action) << 2));
+            writeByte(static_cast<uint8_t>(event.click.modifiers));
+            break;
+        case InputContext::InputEvent::Type::Scroll:
+            writeRecord(Record::Scroll);
+            writeVarint(event.time - time);
+            writeVarint(event.value.x);
+            writeVarint(event.value.y);
+            break;
+        case InputContext::InputEvent::Type::Enter:
+            writeRecord(Record::Enter);
+            writeVarint(event.time - time);
+            writeByte(event.enter ? 1 : 0);
+            break;
+        case InputContext::InputEvent::Type::Key:
+        case InputContext::InputEvent::Type::Text: break;
+        }
+    }
+
+    void InputRecorder::recordClearButtons() { writeRecord(Record::ClearButtons); }
+
+    void InputRecorder::writeRecord(const Record record) { writeByte(static_cast<uint8_t>(record)); }
+
+    void InputRecorder::writeByte(const uint8_t value) { data.emplace_back(static_cast<std::byte>(value)); }
+
+    void InputRecorder::writeVarint(const int64_t value)
+    {
+        // Zigzag encoding maps small negative values to small unsigned values.
+        auto v = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        while (v >= 0x80)
+        {
+            writeByte(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        writeByte(static_cast<uint8_t>(v));
+    }
+}  // namespace floah
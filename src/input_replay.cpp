@@ -0,0 +1,323 @@
+#include "floah-put/input_replay.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_recorder.h"
+
+namespace floah
+{
+    namespace
+    {
+        /**
+         * \brief Reads records from a stream. Reads past the end fail and leave the reader in the failed state.
+         */
+        class Reader
+        {
+        public:
+            explicit Reader(const std::span<const std::byte> d) : data(d) {}
+
+            [[nodiscard]] bool done() const noexcept { return offset == data.size(); }
+
+            [[nodiscard]] bool failed() const noexcept { return fail; }
+
+            [[nodiscard]] uint8_t readByte() noexcept
+            {
+                if (offset == data.size())
+                {
+                    fail = true;
+                    return 0;
+                }
+                return static_cast<uint8_t>(data[offset++]);
+            }
+
+            [[nodiscard]] uint32_t readUint32() noexcept
+            {
+                uint32_t value = 0;
+                for (uint32_t i = 0; i < 4; i++) value |= static_cast<uint32_t>(readByte()) << (i * 8);
+                return value;
+            }
+
+            [[nodiscard]] int64_t readVarint() noexcept
+            {
+                uint64_t v = 0;
+                for (uint32_t shift = 0; shift < 64; shift += 7)
+                {
+                    const auto b = readByte();
+                    v |= static_cast<uint64_t>(b & 0x7f) << shift;
+                    if ((b & 0x80) == 0) return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+                }
+                fail = true;
+                return 0;
+            }
+
+        private:
+            std::span<const std::byte> data;
+
+            size_t offset = 0;
+
+            bool fail = false;
+        };
+
+        [[nodiscard]] bool validHeader(const std::span<const std::byte> data) noexcept
+        {
+            Reader reader(data);
+            if (reader.readUint32() != InputRecorder::magic) return false;
+            const auto version = reader.readUint32();
+            return version >= 1 && version <= InputRecorder::version && !reader.failed();
+        }
+    }  // namespace
+
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputReplay::InputReplay() = default;
+
+    InputReplay::~InputReplay() noexcept { close(); }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::span<const std::byte> InputReplay::getData() const noexcept { return data; }
+
+    ////////////////////////////////////////////////////////////////
+    // Replay.
+    ////////////////////////////////////////////////////////////////
+
+    bool InputReplay::open(const std::filesystem::path& path)
+    {
+        close();
+
+#ifdef _WIN32
+        const auto file = CreateFileW(
+          path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        const auto map = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!map) return false;
+        mapping = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(map);
+        if (!mapping) return false;
+        mappingSize = static_cast<size_t>(size.QuadPart);
+#else
+        const auto file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) return false;
+        struct stat st{};
+        if (fstat(file, &st) != 0 || st.st_size == 0)
+        {
+            ::close(file);
+            return false;
+        }
+        auto* map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+        if (map == MAP_FAILED) return false;
+        mapping     = map;
+        mappingSize = static_cast<size_t>(st.st_size);
+#endif
+
+        data = std::span(static_cast<const std::byte*>(mapping), mappingSize);
+        if (validHeader(data)) return true;
+        close();
+        return false;
+    }
+
+    bool InputReplay::open(const std::span<const std::byte> stream)
+    {
+        close();
+        if (!validHeader(stream)) return false;
+        data = stream;
+        return true;
+    }
+
+    void InputReplay::close() noexcept
+    {
+        if (mapping)
+        {
+#ifdef _WIN32
+            UnmapViewOfFile(mapping);
+#else
+            munmap(mapping, mappingSize);
+#endif
+            mapping     = nullptr;
+            mappingSize = 0;
+        }
+        data = {};
+    }
+
+    InputReplay::Result InputReplay::run(InputContext& context) const
+    {
+        using clock = std::chrono::steady_clock;
+        const auto elapsed = [](const clock::time_point start) {
+            return static_cast<uint64_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+        };
+
+        Result result;
+        if (data.empty()) return result;
+
+        Reader reader(data);
+        static_cast<void>(reader.readUint32());
+        const auto version = reader.readUint32();
+
+        // Version 1 stored whole pixels and steps.
+        const int64_t scale = version == 1 ? InputContext::subpixelScale : 1;
+
+        // Time and cursors are stored as differences with their previous values, starting at 0.
+        int64_t                                      time    = 0;
+        uint32_t                                     pointer = InputContext::mousePointer;
+        std::vector<std::pair<uint32_t, math::int2>> cursors;
+
+        // Events are submitted with their recorded time, which can differ from the context time for events of
+        // producers. Versions before 3 did not store it.
+        const auto readEventTime = [&] { return version >= 3 ? time + reader.readVarint() : time; };
+        const auto submit        = [&](const InputContext::InputEvent& event) {
+            context.submitEvent(event);
+            result.events++;
+        };
+
+        const auto start = clock::now();
+        while (!reader.done())
+        {
+            using Record = InputRecorder::Record;
+            using Event  = InputContext::InputEvent;
+            switch (static_cast<Record>(reader.readByte()))
+            {
+            case Record::PrePoll: context.prePoll(); break;
+            case Record::PostPoll:
+            {
+                const auto frameStart = clock::now();
+                context.postPoll();
+                result.frameTimes.emplace_back(elapsed(frameStart));
+                result.frames++;
+                break;
+            }
+            case Record::Time:
+                time += reader.readVarint();
+                if (!reader.failed()) context.setTime(time);
+                break;
+            case Record::Focus:
+            {
+                const auto focus = reader.readByte() != 0;
+                if (!reader.failed()) context.setFocus(focus);
+                break;
+            }
+            case Record::Enter:
+            {
+                const auto t     = readEventTime();
+                const auto enter = reader.readByte() != 0;
+                if (reader.failed()) break;
+                submit(Event{.type = Event::Type::Enter, .time = t, .enter = enter, .pointer = pointer});
+                break;
+            }
+            case Record::Cursor:
+            {
+                const auto t = readEventTime();
+                const auto x = reader.readVarint();
+                const auto y = reader.readVarint();
+                if (reader.failed()) break;
+                auto it = std::ranges::find(cursors, pointer, &std::pair<uint32_t, math::int2>::first);
+                if (it == cursors.end()) it = cursors.emplace(cursors.end(), pointer, math::int2{});
+                auto& cursor = it->second;
+                cursor =
+                  math::int2(static_cast<int32_t>(cursor.x + x * scale), static_cast<int32_t>(cursor.y + y * scale));
+                submit(Event{.type = Event::Type::Cursor, .time = t, .value = cursor, .pointer = pointer});
+                break;
+            }
+            case Record::Button:
+            {
+                const auto t         = readEventTime();
+                const auto button    = reader.readByte();
+                const auto modifiers = reader.readByte();
+                if (reader.failed()) break;
+                submit(Event{.type    = Event::Type::Button,
+                             .time    = t,
+                             .click   = {.button    = static_cast<InputContext::MouseButton>(button & 3),
+                                         .action    = static_cast<InputContext::MouseAction>(button >> 2 & 1),
+                                         .modifiers = static_cast<InputContext::MouseModifiers>(modifiers),
+                                         .pointer   = pointer},
+                             .pointer = pointer});
+                break;
+            }
+            case Record::Scroll:
+            {
+                const auto t = readEventTime();
+                const auto x = reader.readVarint();
+                const auto y = reader.readVarint();
+                if (reader.failed()) break;
+                submit(Event{.type    = Event::Type::Scroll,
+                             .time    = t,
+                             .value   = math::int2(static_cast<int32_t>(x * scale), static_cast<int32_t>(y * scale)),
+                             .pointer = pointer});
+                break;
+            }
+            case Record::ClearButtons: context.clearMouseButton(); break;
+            case Record::Pointer:
+            {
+                const auto id = reader.readVarint();
+                if (!reader.failed()) pointer = static_cast<uint32_t>(id);
+                break;
+            }
+            case Record::Key:
+            {
+                const auto t         = readEventTime();
+                const auto key       = reader.readVarint();
+                const auto scancode  = reader.readVarint();
+                const auto action    = reader.readByte();
+                const auto modifiers = reader.readByte();
+                if (reader.failed()) break;
+                submit(Event{.type = Event::Type::Key,
+                             .time = t,
+                             .key  = {.key       = static_cast<int32_t>(key),
+                                      .scancode  = static_cast<int32_t>(scancode),
+                                      .action    = static_cast<InputContext::KeyAction>(action),
+                                      .modifiers = static_cast<InputContext::MouseModifiers>(modifiers)}});
+                break;
+            }
+            case Record::Text:
+            {
+                const auto t         = readEventTime();
+                const auto codepoint = reader.readVarint();
+                if (reader.failed()) break;
+                submit(Event{.type = Event::Type::Text, .time = t, .codepoint = static_cast<char32_t>(codepoint)});
+                break;
+            }
+            default: result.complete = false; break;
+            }
+
+            if (reader.failed()) result.complete = false;
+            if (!result.complete) break;
+        }
+        result.totalTime = elapsed(start);
+
+        return result;
+    }
+}  // namespace floah
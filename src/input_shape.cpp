@@ -0,0 +1,139 @@
+#include "floah-put/input_shape.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputShape InputShape::rect(const InputBounds& bounds) noexcept
+    {
+        return InputShape{.type = Type::Rect, .bounds = bounds};
+    }
+
+    InputShape InputShape::roundedRect(const InputBounds& bounds, const int32_t radius) noexcept
+    {
+        return InputShape{.type = Type::RoundedRect, .bounds = bounds, .radius = std::max(radius, 0)};
+    }
+
+    InputShape InputShape::ellipse(const InputBounds& bounds) noexcept
+    {
+        return InputShape{.type = Type::Ellipse, .bounds = bounds};
+    }
+
+    InputShape InputShape::polygon(const std::span<const math::int2> vertices) noexcept
+    {
+        constexpr auto min = std::numeric_limits<int32_t>::min();
+        constexpr auto max = std::numeric_limits<int32_t>::max();
+
+        // Pixels whose center lies past the largest vertex are outside, so it is the exclusive upper corner.
+        auto bounds = InputBounds{.lower = math::int2(max, max), .upper = math::int2(min, min)};
+        for (const auto v : vertices)
+        {
+            bounds.lower = math::int2(std::min(bounds.lower.x, v.x), std::min(bounds.lower.y, v.y));
+            bounds.upper = math::int2(std::max(bounds.upper.x, v.x), std::max(bounds.upper.y, v.y));
+        }
+
+        return InputShape{.type = Type::Polygon, .bounds = bounds, .vertices = vertices};
+    }
+
+    InputShape InputShape::mask(const InputBounds&             bounds,
+                                const std::span<const uint8_t> alpha,
+                                const uint8_t                  threshold,
+                                const size_t                   stride) noexcept
+    {
+        const auto width = static_cast<size_t>(std::max(bounds.upper.x - bounds.lower.x, 0));
+        return InputShape{.type      = Type::Mask,
+                          .bounds    = bounds,
+                          .threshold = threshold,
+                          .alpha     = alpha,
+                          .stride    = stride ? stride : width};
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Intersection.
+    ////////////////////////////////////////////////////////////////
+
+    bool InputShape::contains(const math::int2 point) const noexcept
+    {
+        if (!bounds.contains(point)) return false;
+
+        // Curved shapes are evaluated at twice the resolution, so that pixel centers have integer coordinates. Must
+        // match InputShapeBuffer::test.
+        const auto curve = [&](const float scaleX, const float scaleY, const float extentX, const float extentY,
+                               const float radius2) {
+            const auto dx = static_cast<float>(2 * static_cast<int64_t>(point.x) + 1 -
+                                               (static_cast<int64_t>(bounds.lower.x) + bounds.upper.x));
+            const auto dy = static_cast<float>(2 * static_cast<int64_t>(point.y) + 1 -
+                                               (static_cast<int64_t>(bounds.lower.y) + bounds.upper.y));
+            const auto qx = std::max(std::abs(dx) * scaleX - extentX, 0.0f);
+            const auto qy = std::max(std::abs(dy) * scaleY - extentY, 0.0f);
+            return qx * qx + qy * qy <= radius2;
+        };
+
+        const auto w = bounds.upper.x - bounds.lower.x;
+        const auto h = bounds.upper.y - bounds.lower.y;
+
+        switch (type)
+        {
+        case Type::Rect: return true;
+        case Type::RoundedRect:
+        {
+            const auto r =
+              std::min({static_cast<int64_t>(radius) * 2, static_cast<int64_t>(w), static_cast<int64_t>(h)});
+            return curve(1.0f,
+                         1.0f,
+                         static_cast<float>(w - r),
+                         static_cast<float>(h - r),
+                         static_cast<float>(r) * static_cast<float>(r));
+        }
+        case Type::Ellipse:
+            return curve(1.0f / static_cast<float>(w), 1.0f / static_cast<float>(h), 0.0f, 0.0f, 1.0f);
+        case Type::Polygon:
+        {
+            if (vertices.size() < 3) return false;
+
+            // Inside if the pixel center is on the same side of all edges.
+            const auto px  = 2 * static_cast<int64_t>(point.x) + 1;
+            const auto py  = 2 * static_cast<int64_t>(point.y) + 1;
+            bool       pos = false;
+            bool       neg = false;
+            for (size_t i = 0; i < vertices.size(); i++)
+            {
+                const auto a     = vertices[i];
+                const auto b     = vertices[(i + 1) % vertices.size()];
+                const auto cross = (static_cast<int64_t>(b.x) - a.x) * (py - 2 * static_cast<int64_t>(a.y)) -
+                                   (static_cast<int64_t>(b.y) - a.y) * (px - 2 * static_cast<int64_t>(a.x));
+                pos |= cross > 0;
+                neg |= cross < 0;
+            }
+            return !(pos && neg);
+        }
+        case Type::Mask:
+        {
+            if (!validMask()) return false;
+            const auto x = static_cast<size_t>(point.x - bounds.lower.x);
+            const auto y = static_cast<size_t>(point.y - bounds.lower.y);
+            return alpha[y * stride + x] >= threshold;
+        }
+        }
+
+        return false;
+    }
+
+    bool InputShape::validMask() const noexcept
+    {
+        if (bounds.empty()) return false;
+        const auto w = static_cast<size_t>(bounds.upper.x - bounds.lower.x);
+        const auto h = static_cast<size_t>(bounds.upper.y - bounds.lower.y);
+        return stride >= w && alpha.size() >= (h - 1) * stride + w;
+    }
+}  // namespace floah
@@ -0,0 +1,299 @@
+#include "floah-put/input_shape_buffer.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLOAH_PUT_SSE2
+#include <emmintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_element.h"
+
+namespace
+{
+    constexpr auto none = std::numeric_limits<uint32_t>::max();
+}  // namespace
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputShapeBuffer::InputShapeBuffer(std::pmr::memory_resource* resource) :
+        lowerX(resource),
+        lowerY(resource),
+        upperX(resource),
+        upperY(resource),
+        centerX(resource),
+        centerY(resource),
+        scaleX(resource),
+        scaleY(resource),
+        extentX(resource),
+        extentY(resource),
+        radius2(resource),
+        shapes(resource),
+        entries(resource)
+    {
+    }
+
+    InputShapeBuffer::~InputShapeBuffer() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t InputShapeBuffer::getBlockCount() const noexcept { return lowerX.size() / blockSize; }
+
+    bool InputShapeBuffer::hasShape(const size_t index) const noexcept { return shapes[index] != none; }
+
+    ////////////////////////////////////////////////////////////////
+    // Buffer.
+    ////////////////////////////////////////////////////////////////
+
+    void InputShapeBuffer::build(const std::span<InputElement* const> elements,
+                                 const std::span<const math::int2> offsets)
+    {
+        constexpr auto min  = std::numeric_limits<int32_t>::min();
+        constexpr auto max  = std::numeric_limits<int32_t>::max();
+        const auto     size = (elements.size() + blockSize - 1) / blockSize * blockSize;
+
+        // Padding is initialized to inverted bounds and curves that always pass.
+        lowerX.assign(size, max);
+        lowerY.assign(size, max);
+        upperX.assign(size, min);
+        upperY.assign(size, min);
+        centerX.assign(size, 0);
+        centerY.assign(size, 0);
+        scaleX.assign(size, 0);
+        scaleY.assign(size, 0);
+        extentX.assign(size, 0);
+        extentY.assign(size, 0);
+        radius2.assign(size, 0);
+        shapes.assign(size, none);
+        entries.clear();
+
+        for (size_t i = 0; i < elements.size(); i++) update(i, *elements[i], offsets[i]);
+    }
+
+    void InputShapeBuffer::resize(const size_t count)
+    {
+        constexpr auto min  = std::numeric_limits<int32_t>::min();
+        constexpr auto max  = std::numeric_limits<int32_t>::max();
+        const auto     size = (count + blockSize - 1) / blockSize * blockSize;
+
+        lowerX.resize(size);
+        lowerY.resize(size);
+        upperX.resize(size);
+        upperY.resize(size);
+        centerX.resize(size);
+        centerY.resize(size);
+        scaleX.resize(size);
+        scaleY.resize(size);
+        extentX.resize(size);
+        extentY.resize(size);
+        radius2.resize(size);
+        shapes.resize(size, none);
+
+        // Padding is set to inverted bounds and curves that always pass. Entries of elements past the new count are
+        // only dropped when the entries are compacted.
+        for (auto i = count; i < size; i++)
+        {
+            lowerX[i]  = max;
+            lowerY[i]  = max;
+            upperX[i]  = min;
+            upperY[i]  = min;
+            centerX[i] = 0;
+            centerY[i] = 0;
+            scaleX[i]  = 0;
+            scaleY[i]  = 0;
+            extentX[i] = 0;
+            extentY[i] = 0;
+            radius2[i] = 0;
+            shapes[i]  = none;
+        }
+    }
+
+    void InputShapeBuffer::update(const size_t index, const InputElement& elem, const math::int2 offset)
+    {
+        constexpr auto min = std::numeric_limits<int32_t>::min();
+        constexpr auto max = std::numeric_limits<int32_t>::max();
+
+        scaleX[index]  = 0;
+        scaleY[index]  = 0;
+        extentX[index] = 0;
+        extentY[index] = 0;
+        radius2[index] = 0;
+
+        const auto shape = elem.getInputShape();
+        if (!shape)
+        {
+            // Elements without a shape are only culled by their bounds, if any.
+            const auto bounds = elem.getInputBounds();
+            const auto b      = bounds ? bounds->translate(offset) :
+                                         InputBounds{.lower = math::int2(min, min), .upper = math::int2(max, max)};
+            lowerX[index]     = b.lower.x;
+            lowerY[index]     = b.lower.y;
+            upperX[index]     = b.upper.x;
+            upperY[index]     = b.upper.y;
+            centerX[index]    = 0;
+            centerY[index]    = 0;
+            shapes[index]     = none;
+            return;
+        }
+
+        const auto b   = shape->bounds.translate(offset);
+        lowerX[index]  = b.lower.x;
+        lowerY[index]  = b.lower.y;
+        upperX[index]  = b.upper.x;
+        upperY[index]  = b.upper.y;
+        centerX[index] = static_cast<double>(b.lower.x) + b.upper.x;
+        centerY[index] = static_cast<double>(b.lower.y) + b.upper.y;
+
+        // Same parameters as InputShape::contains.
+        const auto w = b.upper.x - b.lower.x;
+        const auto h = b.upper.y - b.lower.y;
+        switch (shape->type)
+        {
+        case InputShape::Type::Rect: break;
+        case InputShape::Type::RoundedRect:
+        {
+            const auto r =
+              std::min({static_cast<int64_t>(shape->radius) * 2, static_cast<int64_t>(w), static_cast<int64_t>(h)});
+            scaleX[index]  = 1.0f;
+            scaleY[index]  = 1.0f;
+            extentX[index] = static_cast<float>(w - r);
+            extentY[index] = static_cast<float>(h - r);
+            radius2[index] = static_cast<float>(r) * static_cast<float>(r);
+            break;
+        }
+        case InputShape::Type::Ellipse:
+            scaleX[index]  = 1.0f / static_cast<float>(w);
+            scaleY[index]  = 1.0f / static_cast<float>(h);
+            radius2[index] = 1.0f;
+            break;
+        case InputShape::Type::Polygon:
+        case InputShape::Type::Mask: break;
+        }
+
+        // Reuse the entry of an element that already had a shape.
+        if (shapes[index] == none)
+        {
+            // Elements that lose their shape or are dropped by resize leave their entry behind.
+            if (entries.size() >= shapes.size() * 2 + blockSize) compact();
+            shapes[index] = static_cast<uint32_t>(entries.size());
+            entries.emplace_back();
+        }
+        entries[shapes[index]] = Entry{.shape = *shape, .offset = offset};
+    }
+
+    void InputShapeBuffer::clear() noexcept
+    {
+        lowerX.clear();
+        lowerY.clear();
+        upperX.clear();
+        upperY.clear();
+        centerX.clear();
+        centerY.clear();
+        scaleX.clear();
+        scaleY.clear();
+        extentX.clear();
+        extentY.clear();
+        radius2.clear();
+        shapes.clear();
+        entries.clear();
+    }
+
+    void InputShapeBuffer::compact()
+    {
+        std::pmr::vector<Entry> compacted(entries.get_allocator());
+        for (auto& shape : shapes)
+        {
+            if (shape == none) continue;
+            compacted.emplace_back(entries[shape]);
+            shape = static_cast<uint32_t>(compacted.size() - 1);
+        }
+        std::swap(entries, compacted);
+    }
+
+    bool InputShapeBuffer::intersect(const size_t index, const math::int2 point) const noexcept
+    {
+        const auto& entry = entries[shapes[index]];
+        return entry.shape.contains(point - entry.offset);
+    }
+
+    uint32_t InputShapeBuffer::test(const size_t block, const math::int2 point) const noexcept
+    {
+        const auto offset = block * blockSize;
+
+#ifdef FLOAH_PUT_SSE2
+        const auto px   = _mm_set1_epi32(point.x);
+        const auto py   = _mm_set1_epi32(point.y);
+        const auto px2  = _mm_set1_pd(2.0 * point.x + 1);
+        const auto py2  = _mm_set1_pd(2.0 * point.y + 1);
+        const auto sign = _mm_set1_ps(-0.0f);
+        const auto zero = _mm_setzero_ps();
+        uint32_t   mask = 0;
+        for (size_t i = 0; i < blockSize; i += 4)
+        {
+            const auto j  = offset + i;
+            const auto lx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowerX.data() + j));
+            const auto ly = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowerY.data() + j));
+            const auto ux = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upperX.data() + j));
+            const auto uy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upperY.data() + j));
+
+            // lower <= point < upper, written as !(lower > point) && upper > point.
+            const auto outside = _mm_or_si128(_mm_cmpgt_epi32(lx, px), _mm_cmpgt_epi32(ly, py));
+            const auto inside  = _mm_and_si128(_mm_cmpgt_epi32(ux, px), _mm_cmpgt_epi32(uy, py));
+            const auto bounds  = _mm_andnot_si128(outside, inside);
+
+            // Distance of the pixel center to the curve. Subtracted in double, which is exact for all int32_t
+            // coordinates, and rounded to float once like InputShape::contains.
+            const auto distance = [&](const __m128d p2, const double* center) {
+                const auto lo = _mm_cvtpd_ps(_mm_sub_pd(p2, _mm_loadu_pd(center + j)));
+                const auto hi = _mm_cvtpd_ps(_mm_sub_pd(p2, _mm_loadu_pd(center + j + 2)));
+                return _mm_andnot_ps(sign, _mm_movelh_ps(lo, hi));
+            };
+            const auto dx = distance(px2, centerX.data());
+            const auto dy = distance(py2, centerY.data());
+            const auto qx =
+              _mm_max_ps(_mm_sub_ps(_mm_mul_ps(dx, _mm_loadu_ps(scaleX.data() + j)), _mm_loadu_ps(extentX.data() + j)),
+                         zero);
+            const auto qy =
+              _mm_max_ps(_mm_sub_ps(_mm_mul_ps(dy, _mm_loadu_ps(scaleY.data() + j)), _mm_loadu_ps(extentY.data() + j)),
+                         zero);
+            const auto curve = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy)),
+                                            _mm_loadu_ps(radius2.data() + j));
+
+            const auto result = _mm_and_ps(_mm_castsi128_ps(bounds), curve);
+            mask |= static_cast<uint32_t>(_mm_movemask_ps(result)) << i;
+        }
+        return mask;
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < blockSize; i++)
+        {
+            const auto j = offset + i;
+            const auto bounds =
+              point.x >= lowerX[j] && point.y >= lowerY[j] && point.x < upperX[j] && point.y < upperY[j];
+            const auto dx = std::abs(static_cast<float>(2.0 * point.x + 1 - centerX[j]));
+            const auto dy = std::abs(static_cast<float>(2.0 * point.y + 1 - centerY[j]));
+            const auto qx = std::max(dx * scaleX[j] - extentX[j], 0.0f);
+            const auto qy = std::max(dy * scaleY[j] - extentY[j], 0.0f);
+            mask |= static_cast<uint32_t>(bounds && qx * qx + qy * qy <= radius2[j]) << i;
+        }
+        return mask;
+#endif
+    }
+}  // namespace floah
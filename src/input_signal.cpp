@@ -0,0 +1,43 @@
+#include "floah-put/input_signal.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputSignal::InputSignal() = default;
+
+    InputSignal::~InputSignal() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    uint64_t InputSignal::get() const noexcept { return count.load(); }
+
+    ////////////////////////////////////////////////////////////////
+    // Signalling.
+    ////////////////////////////////////////////////////////////////
+
+    void InputSignal::notify() noexcept
+    {
+        // Either the waiter sees the new count before going to sleep, or this sees the waiter. Taking the lock makes
+        // sure the waiter is not between checking the count and going to sleep.
+        count.fetch_add(1);
+        if (waiters.load() == 0) return;
+        {
+            const std::lock_guard lock(mutex);
+        }
+        condition.notify_all();
+    }
+
+    bool InputSignal::wait(const uint64_t seen, const std::chrono::nanoseconds timeout)
+    {
+        waiters.fetch_add(1);
+        std::unique_lock lock(mutex);
+        const auto       notified = condition.wait_for(lock, timeout, [&] { return count.load() != seen; });
+        waiters.fetch_sub(1);
+        return notified;
+    }
+}  // namespace floah
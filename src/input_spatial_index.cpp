@@ -0,0 +1,286 @@
+#include "floah-put/input_spatial_index.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <limits>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_element.h"
+
+namespace
+{
+    constexpr auto none = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * \brief Get the cell containing a coordinate on one axis, clamped to the grid. Coordinates before the origin
+     * round towards zero, but are clamped to the first cell anyway.
+     */
+    int64_t getCell(const int64_t v, const int32_t origin, const int32_t cellSize, const int64_t count) noexcept
+    {
+        return std::clamp<int64_t>((v - origin) / cellSize, 0, count - 1);
+    }
+}  // namespace
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputSpatialIndex::InputSpatialIndex(std::pmr::memory_resource* resource) :
+        bounds(resource), kinds(resource), unbounded(resource), cells(resource), links(resource)
+    {
+    }
+
+    InputSpatialIndex::~InputSpatialIndex() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    int32_t InputSpatialIndex::getCellSize() const noexcept { return cellSize; }
+
+    bool InputSpatialIndex::isStale() const noexcept { return updateCount > std::max<size_t>(builtCount, 64); }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    void InputSpatialIndex::setCellSize(const int32_t size) noexcept { preferredCellSize = std::max(size, 1); }
+
+    ////////////////////////////////////////////////////////////////
+    // Index.
+    ////////////////////////////////////////////////////////////////
+
+    void InputSpatialIndex::build(const std::span<InputElement* const> elements,
+                                   const std::span<const InputHandle>   handles,
+                                   const std::span<const math::int2>    offsets)
+    {
+        clear();
+
+        // Gather global bounds of all elements and calculate their union.
+        size_t slotCount = 0;
+        for (const auto handle : handles) slotCount = std::max<size_t>(slotCount, handle.index + 1);
+        bounds.resize(slotCount);
+        kinds.assign(slotCount, Kind::None);
+        constexpr auto min     = std::numeric_limits<int32_t>::min();
+        constexpr auto max     = std::numeric_limits<int32_t>::max();
+        InputBounds    extent  = {.lower = math::int2(max, max), .upper = math::int2(min, min)};
+        size_t         bounded = 0;
+        for (size_t i = 0; i < elements.size(); i++)
+        {
+            const auto index = handles[i].index;
+            const auto b     = elements[i]->getInputBounds();
+            if (!b)
+            {
+                kinds[index] = Kind::Unbounded;
+                unbounded.emplace_back(index);
+                continue;
+            }
+
+            // Elements with empty bounds can never be hit and are not added to any cell.
+            bounds[index] = b->translate(offsets[i]);
+            if (bounds[index].empty()) continue;
+
+            kinds[index]   = Kind::Cells;
+            extent.lower.x = std::min(extent.lower.x, bounds[index].lower.x);
+            extent.lower.y = std::min(extent.lower.y, bounds[index].lower.y);
+            extent.upper.x = std::max(extent.upper.x, bounds[index].upper.x);
+            extent.upper.y = std::max(extent.upper.y, bounds[index].upper.y);
+            bounded++;
+        }
+        builtCount = elements.size();
+
+        if (bounded == 0) return;
+
+        fit(extent, bounded);
+        for (const auto handle : handles)
+            if (kinds[handle.index] == Kind::Cells) link(handle.index);
+    }
+
+    void InputSpatialIndex::update(const InputHandle handle, const InputElement& elem, const math::int2 offset)
+    {
+        const auto index = handle.index;
+        if (index >= kinds.size())
+        {
+            bounds.resize(index + 1);
+            kinds.resize(index + 1, Kind::None);
+        }
+        remove(handle);
+
+        const auto b = elem.getInputBounds();
+        if (!b)
+        {
+            kinds[index] = Kind::Unbounded;
+            unbounded.emplace_back(index);
+            return;
+        }
+
+        bounds[index] = b->translate(offset);
+        if (bounds[index].empty()) return;
+
+        // The first bounded element determines the grid until the next build.
+        if (columns == 0) fit(bounds[index], 1);
+        kinds[index] = Kind::Cells;
+        link(index);
+    }
+
+    void InputSpatialIndex::remove(const InputHandle handle) noexcept
+    {
+        const auto index = handle.index;
+        if (index >= kinds.size()) return;
+
+        switch (kinds[index])
+        {
+        case Kind::None: break;
+        case Kind::Unbounded: std::erase(unbounded, index); break;
+        case Kind::Cells: unlink(index); break;
+        }
+        kinds[index] = Kind::None;
+        updateCount++;
+    }
+
+    void InputSpatialIndex::clear() noexcept
+    {
+        columns     = 0;
+        rows        = 0;
+        firstFree   = none;
+        builtCount  = 0;
+        updateCount = 0;
+        bounds.clear();
+        kinds.clear();
+        unbounded.clear();
+        cells.clear();
+        links.clear();
+    }
+
+    void InputSpatialIndex::query(const math::int2                point,
+                                  const std::span<const uint32_t> positions,
+                                  std::pmr::vector<uint32_t>&     candidates) const
+    {
+        candidates.clear();
+
+        // Points outside of the grid are looked up in the nearest border cell, which holds all elements that extend
+        // past the grid on that side.
+        if (columns > 0)
+        {
+            const auto x = getCell(point.x, origin.x, cellSize, columns);
+            const auto y = getCell(point.y, origin.y, cellSize, rows);
+            for (auto l = cells[static_cast<size_t>(y * columns + x)]; l != none; l = links[l].next)
+                if (bounds[links[l].element].contains(point)) candidates.emplace_back(positions[links[l].element]);
+        }
+
+        for (const auto i : unbounded) candidates.emplace_back(positions[i]);
+        std::ranges::sort(candidates);
+    }
+
+    void InputSpatialIndex::query(const InputBounds&              region,
+                                  const std::span<const uint32_t> positions,
+                                  std::pmr::vector<uint32_t>&     candidates,
+                                  std::pmr::vector<InputBounds>&  candidateBounds) const
+    {
+        candidates.clear();
+
+        // Gather elements from all cells overlapping the region. Elements can be in more than one cell.
+        if (columns > 0 && !region.empty())
+        {
+            const auto range = getCells(region);
+            for (auto y = range.y0; y <= range.y1; y++)
+            {
+                for (auto x = range.x0; x <= range.x1; x++)
+                {
+                    for (auto l = cells[static_cast<size_t>(y * columns + x)]; l != none; l = links[l].next)
+                        if (bounds[links[l].element].overlaps(region)) candidates.emplace_back(links[l].element);
+                }
+            }
+        }
+        candidates.insert(candidates.end(), unbounded.begin(), unbounded.end());
+
+        // Sort by position. Duplicates are then adjacent.
+        std::ranges::sort(candidates, {}, [positions](const uint32_t i) { return positions[i]; });
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        constexpr auto min = std::numeric_limits<int32_t>::min();
+        constexpr auto max = std::numeric_limits<int32_t>::max();
+        candidateBounds.resize(candidates.size());
+        std::ranges::transform(candidates, candidateBounds.begin(), [this](const uint32_t i) {
+            return kinds[i] == Kind::Unbounded ?
+                     InputBounds{.lower = math::int2(min, min), .upper = math::int2(max, max)} :
+                     bounds[i];
+        });
+        for (auto& i : candidates) i = positions[i];
+    }
+
+    void InputSpatialIndex::fit(const InputBounds& extent, const size_t count)
+    {
+        // Grow cells until their number is proportional to the number of elements.
+        const auto    width    = static_cast<int64_t>(extent.upper.x) - extent.lower.x;
+        const auto    height   = static_cast<int64_t>(extent.upper.y) - extent.lower.y;
+        const int64_t maxCells = std::max<int64_t>(1024, static_cast<int64_t>(count) * 4);
+        int64_t       size     = preferredCellSize;
+        while (((width + size - 1) / size) * ((height + size - 1) / size) > maxCells) size *= 2;
+
+        cellSize = static_cast<int32_t>(std::min<int64_t>(size, std::numeric_limits<int32_t>::max()));
+        origin   = extent.lower;
+        columns  = (width + cellSize - 1) / cellSize;
+        rows     = (height + cellSize - 1) / cellSize;
+        cells.assign(static_cast<size_t>(columns * rows), none);
+    }
+
+    InputSpatialIndex::CellRange InputSpatialIndex::getCells(const InputBounds& b) const noexcept
+    {
+        return CellRange{.x0 = getCell(b.lower.x, origin.x, cellSize, columns),
+                         .y0 = getCell(b.lower.y, origin.y, cellSize, rows),
+                         .x1 = getCell(static_cast<int64_t>(b.upper.x) - 1, origin.x, cellSize, columns),
+                         .y1 = getCell(static_cast<int64_t>(b.upper.y) - 1, origin.y, cellSize, rows)};
+    }
+
+    void InputSpatialIndex::link(const uint32_t element)
+    {
+        const auto range = getCells(bounds[element]);
+        for (auto y = range.y0; y <= range.y1; y++)
+        {
+            for (auto x = range.x0; x <= range.x1; x++)
+            {
+                auto& first = cells[static_cast<size_t>(y * columns + x)];
+                auto  l     = firstFree;
+                if (l != none)
+                    firstFree = links[l].next;
+                else
+                {
+                    l = static_cast<uint32_t>(links.size());
+                    links.emplace_back();
+                }
+                links[l] = Link{.element = element, .next = first};
+                first    = l;
+            }
+        }
+    }
+
+    void InputSpatialIndex::unlink(const uint32_t element) noexcept
+    {
+        const auto range = getCells(bounds[element]);
+        for (auto y = range.y0; y <= range.y1; y++)
+        {
+            for (auto x = range.x0; x <= range.x1; x++)
+            {
+                // Find the link of the element in the cell and move it to the free list.
+                for (auto* l = &cells[static_cast<size_t>(y * columns + x)]; *l != none; l = &links[*l].next)
+                {
+                    if (links[*l].element != element) continue;
+                    const auto unused  = *l;
+                    *l                 = links[unused].next;
+                    links[unused].next = firstFree;
+                    firstFree          = unused;
+                    break;
+                }
+            }
+        }
+    }
+}  // namespace floah
@@ -0,0 +1,145 @@
+#include "floah-put/input_stats.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputHistogram::InputHistogram() = default;
+
+    InputHistogram::~InputHistogram() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t InputHistogram::getCount() const noexcept { return count; }
+
+    std::span<const uint32_t, InputHistogram::bucketCount> InputHistogram::getBuckets() const noexcept
+    {
+        return buckets;
+    }
+
+    uint64_t InputHistogram::getMax() const noexcept
+    {
+        uint64_t max = 0;
+        for (size_t i = 0; i < count; i++) max = std::max(max, window[i]);
+        return max;
+    }
+
+    double InputHistogram::getMean() const noexcept
+    {
+        if (count == 0) return 0;
+        double sum = 0;
+        for (size_t i = 0; i < count; i++) sum += static_cast<double>(window[i]);
+        return sum / static_cast<double>(count);
+    }
+
+    uint64_t InputHistogram::getPercentile(const double p) const
+    {
+        if (count == 0) return 0;
+        std::vector<uint64_t> sorted(window.begin(), window.begin() + static_cast<ptrdiff_t>(count));
+        const auto            index =
+          std::min(count - 1, static_cast<size_t>(std::clamp(p, 0.0, 1.0) * static_cast<double>(count - 1) + 0.5));
+        std::ranges::nth_element(sorted, sorted.begin() + static_cast<ptrdiff_t>(index));
+        return sorted[index];
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Histogram.
+    ////////////////////////////////////////////////////////////////
+
+    void InputHistogram::add(const uint64_t value) noexcept
+    {
+        // Remove oldest value when window is full. While not full, head == count.
+        if (count == windowSize)
+            buckets[std::bit_width(window[head])]--;
+        else
+            count++;
+
+        window[head] = value;
+        buckets[std::bit_width(value)]++;
+        head = (head + 1) % windowSize;
+    }
+
+    void InputHistogram::clear() noexcept
+    {
+        buckets.fill(0);
+        head  = 0;
+        count = 0;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputStats::InputStats() = default;
+
+    InputStats::~InputStats() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t InputStats::getFrameCount() const noexcept { return frameCount; }
+
+    const InputFrameStats& InputStats::getLastFrame() const noexcept { return lastFrame; }
+
+    const InputFrameStats& InputStats::getTotal() const noexcept { return total; }
+
+    const InputHistogram& InputStats::getHistogram(const InputMetric metric) const noexcept
+    {
+        return histograms[static_cast<size_t>(metric)];
+    }
+
+    const InputHistogram& InputStats::getLatencyHistogram(const InputLatency type) const noexcept
+    {
+        return latencies[static_cast<size_t>(type)];
+    }
+
+    uint64_t InputStats::getMaxLatency(const InputLatency type) const noexcept
+    {
+        return maxLatencies[static_cast<size_t>(type)];
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Stats.
+    ////////////////////////////////////////////////////////////////
+
+    void InputStats::record(const InputFrameStats& frame) noexcept
+    {
+        frameCount++;
+        lastFrame = frame;
+        for (size_t i = 0; i < inputMetricCount; i++)
+        {
+            total.values[i] += frame.values[i];
+            histograms[i].add(frame.values[i]);
+        }
+    }
+
+    void InputStats::recordLatency(const InputLatency type, const uint64_t latency) noexcept
+    {
+        const auto i = static_cast<size_t>(type);
+        latencies[i].add(latency);
+        maxLatencies[i] = std::max(maxLatencies[i], latency);
+    }
+
+    void InputStats::clear() noexcept
+    {
+        frameCount = 0;
+        lastFrame  = {};
+        total      = {};
+        for (auto& h : histograms) h.clear();
+        for (auto& h : latencies) h.clear();
+        maxLatencies.fill(0);
+    }
+}  // namespace floah
@@ -0,0 +1,12 @@
+#include "floah-put/input_trace.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputTracer::InputTracer() = default;
+
+    InputTracer::~InputTracer() noexcept = default;
+}  // namespace floah
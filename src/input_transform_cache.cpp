@@ -0,0 +1,86 @@
+#include "floah-put/input_transform_cache.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_element.h"
+#include "floah-put/input_tree.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputTransformCache::InputTransformCache(std::pmr::memory_resource* resource) :
+        transforms(resource), handles(resource), dirty(resource)
+    {
+    }
+
+    InputTransformCache::~InputTransformCache() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    InputTransform InputTransformCache::get(const InputElement& elem, const InputHandle handle) const noexcept
+    {
+        if (handle.index >= transforms.size() || handles[handle.index] != handle)
+            return InputTransform{.offset = elem.getInputOffset()};
+        return transforms[handle.index];
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Cache.
+    ////////////////////////////////////////////////////////////////
+
+    void InputTransformCache::build(const InputTree& tree, const size_t slotCount)
+    {
+        dirty.clear();
+        transforms.resize(slotCount);
+        handles.assign(slotCount, InputHandle{});
+
+        for (const auto& node : tree.getNodes())
+            if (node.handle.valid()) set(*node.element, node.handle);
+    }
+
+    void InputTransformCache::markDirty(const InputElement& elem) { dirty.emplace_back(&elem); }
+
+    bool InputTransformCache::refresh(const InputTree& tree)
+    {
+        if (dirty.empty()) return false;
+
+        // Recalculate transforms of dirty elements and all their descendants. Elements that are marked more than once
+        // (directly or through an ancestor) are simply recalculated more than once. Elements added since the cache was
+        // built are stored as well.
+        const auto nodes = tree.getNodes();
+        for (const auto* elem : dirty)
+        {
+            const auto root = tree.find(*elem);
+            for (auto n = root; n != InputTree::none; n = tree.getNext(n, root))
+                if (nodes[n].handle.valid()) set(*nodes[n].element, nodes[n].handle);
+        }
+
+        dirty.clear();
+        return true;
+    }
+
+    void InputTransformCache::set(const InputElement& elem, const InputHandle handle)
+    {
+        if (handle.index >= transforms.size())
+        {
+            transforms.resize(handle.index + 1);
+            handles.resize(handle.index + 1);
+        }
+        transforms[handle.index] = InputTransform{.offset = elem.getInputOffset()};
+        handles[handle.index]    = handle;
+    }
+
+    void InputTransformCache::clear() noexcept
+    {
+        transforms.clear();
+        handles.clear();
+        dirty.clear();
+    }
+}  // namespace floah
@@ -0,0 +1,156 @@
+#include "floah-put/input_tree.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-put/input_element.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputTree::InputTree(std::pmr::memory_resource* resource) : nodes(resource), lookup(resource) {}
+
+    InputTree::~InputTree() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::span<const InputTree::Node> InputTree::getNodes() const noexcept { return nodes; }
+
+    uint32_t InputTree::getFirstRoot() const noexcept { return firstRoot; }
+
+    uint32_t InputTree::getNext(uint32_t node, const uint32_t root) const noexcept
+    {
+        // Descend into the first child. Otherwise, move up until there is a next sibling, without leaving the subtree.
+        if (nodes[node].firstChild != none) return nodes[node].firstChild;
+        while (node != root)
+        {
+            if (nodes[node].nextSibling != none) return nodes[node].nextSibling;
+            node = nodes[node].parent;
+        }
+        return none;
+    }
+
+    uint32_t InputTree::find(const InputElement& elem) const noexcept
+    {
+        const auto it = lookup.find(&elem);
+        return it == lookup.end() ? none : it->second;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Tree.
+    ////////////////////////////////////////////////////////////////
+
+    void InputTree::build(const std::span<InputElement* const> elements, const std::span<const InputHandle> handles)
+    {
+        clear();
+        for (size_t i = 0; i < elements.size(); i++) insert(*elements[i], handles[i]);
+    }
+
+    void InputTree::insert(const InputElement& elem, const InputHandle handle)
+    {
+        const auto n    = getNode(elem);
+        nodes[n].handle = handle;
+    }
+
+    void InputTree::erase(const InputElement& elem)
+    {
+        const auto n = find(elem);
+        if (n == none) return;
+        nodes[n].handle = {};
+        prune(n);
+    }
+
+    void InputTree::reparent(const InputElement& elem)
+    {
+        const auto n = find(elem);
+        if (n == none) return;
+
+        const auto* parent  = elem.getInputParent();
+        const auto  current = nodes[n].parent;
+        if ((current == none ? nullptr : nodes[current].element) == parent) return;
+
+        // Link to the new parent before pruning the old one, which could otherwise erase shared ancestors.
+        unlink(n);
+        link(n, parent ? getNode(*parent) : none);
+        prune(current);
+    }
+
+    void InputTree::clear() noexcept
+    {
+        nodes.clear();
+        lookup.clear();
+        firstRoot = none;
+        firstFree = none;
+    }
+
+    uint32_t InputTree::getNode(const InputElement& elem)
+    {
+        if (const auto it = lookup.find(&elem); it != lookup.end()) return it->second;
+
+        // Reuse an unused node if there is one.
+        auto n = firstFree;
+        if (n != none)
+        {
+            firstFree = nodes[n].nextSibling;
+            nodes[n]  = Node{.element = &elem};
+        }
+        else
+        {
+            n = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back(Node{.element = &elem});
+        }
+        lookup.emplace(&elem, n);
+
+        const auto* parent = elem.getInputParent();
+        link(n, parent ? getNode(*parent) : none);
+
+        return n;
+    }
+
+    void InputTree::link(const uint32_t node, const uint32_t parent) noexcept
+    {
+        auto& first                 = parent == none ? firstRoot : nodes[parent].firstChild;
+        nodes[node].parent          = parent;
+        nodes[node].previousSibling = none;
+        nodes[node].nextSibling     = first;
+        if (first != none) nodes[first].previousSibling = node;
+        first = node;
+    }
+
+    void InputTree::unlink(const uint32_t node) noexcept
+    {
+        const auto& n = nodes[node];
+        if (n.previousSibling != none)
+            nodes[n.previousSibling].nextSibling = n.nextSibling;
+        else if (n.parent != none)
+            nodes[n.parent].firstChild = n.nextSibling;
+        else
+            firstRoot = n.nextSibling;
+        if (n.nextSibling != none) nodes[n.nextSibling].previousSibling = n.previousSibling;
+    }
+
+    void InputTree::prune(uint32_t node)
+    {
+        while (node != none && !nodes[node].handle.valid() && nodes[node].firstChild == none)
+        {
+            const auto parent = nodes[node].parent;
+            unlink(node);
+            lookup.erase(nodes[node].element);
+            nodes[node] = Node{.nextSibling = firstFree};
+            firstFree   = node;
+            node        = parent;
+        }
+    }
+}  // namespace floah
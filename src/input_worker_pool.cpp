@@ -0,0 +1,94 @@
+#include "floah-put/input_worker_pool.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InputWorkerPool::InputWorkerPool(const size_t threadCount)
+    {
+        threads.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++) threads.emplace_back([this] { work(); });
+    }
+
+    InputWorkerPool::~InputWorkerPool() noexcept
+    {
+        {
+            const std::scoped_lock lock(mutex);
+            stopping = true;
+        }
+        started.notify_all();
+        for (auto& thread : threads) thread.join();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t InputWorkerPool::getThreadCount() const noexcept { return threads.size(); }
+
+    ////////////////////////////////////////////////////////////////
+    // Run.
+    ////////////////////////////////////////////////////////////////
+
+    void InputWorkerPool::runTasks(const size_t taskCount, const Task task, void* data)
+    {
+        if (taskCount == 0) return;
+
+        // Not worth waking up the workers.
+        if (taskCount == 1 || threads.empty())
+        {
+            for (size_t i = 0; i < taskCount; i++) task(data, i);
+            return;
+        }
+
+        {
+            const std::scoped_lock lock(mutex);
+            batchTask = task;
+            batchData = data;
+            batchSize = taskCount;
+            busy      = threads.size();
+            next.store(0, std::memory_order_relaxed);
+            batch++;
+        }
+        started.notify_all();
+
+        execute();
+
+        // Workers may still be executing the last tasks.
+        std::unique_lock lock(mutex);
+        finished.wait(lock, [this] { return busy == 0; });
+        batchTask = nullptr;
+        batchData = nullptr;
+    }
+
+    void InputWorkerPool::execute() noexcept
+    {
+        for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < batchSize;
+             i      = next.fetch_add(1, std::memory_order_relaxed))
+            batchTask(batchData, i);
+    }
+
+    void InputWorkerPool::work()
+    {
+        uint64_t seen = 0;
+        while (true)
+        {
+            {
+                std::unique_lock lock(mutex);
+                started.wait(lock, [&] { return stopping || batch != seen; });
+                if (stopping) return;
+                seen = batch;
+            }
+
+            execute();
+
+            {
+                const std::scoped_lock lock(mutex);
+                if (--busy > 0) continue;
+            }
+            finished.notify_one();
+        }
+    }
+}  // namespace floah